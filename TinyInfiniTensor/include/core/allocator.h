@@ -6,6 +6,7 @@
 #endif
 #include <cstddef>
 #include <map>
+#include <set>
 #include <unordered_set>
 
 namespace infini {
@@ -23,12 +24,14 @@ namespace infini {
     // pointer to the memory actually allocated
     void *ptr;
 
+    // size of the memory actually allocated
+    size_t capacity;
+
     // std:map can store elements with the order of their keys
+    // free blocks keyed by head address, used to find neighbours to merge
     std::map<size_t, size_t> free_blk;
-    // =================================== 作业 ===================================
-    // TODO：可能需要设计一个数据结构来存储free block，以便于管理和合并
-    // HINT: 可以使用一个 map 来存储 free block，key 为 block 的起始/结尾地址，value 为 block 的大小
-    // =================================== 作业 ===================================
+    // the same free blocks as (size, head address), used for best-fit lookup
+    std::set<std::pair<size_t, size_t>> free_by_size;
 
   public:
     Allocator(Runtime runtime);
@@ -47,15 +50,26 @@ namespace infini {
     //     size: size of memory block to be freed
     void free(size_t addr, size_t size);
 
-    // function: perform actual memory allocation
+    // function: perform actual memory allocation. Allocations simulated
+    //           after a previous call are allowed; the memory is reallocated,
+    //           without its contents, if they raised the peak above it
     // return: pointer to the head address of the allocated memory
     void *getPtr();
 
     void info();
 
+    size_t getAlignment() const { return alignment; }
+
+    // function: size of the arena needed by the allocations simulated so far
+    size_t getPeak() const { return peak; }
+
   private:
     // function: memory alignment, rouned up
     // return: size of the aligned memory block
     size_t getAlignedSize(size_t size);
+
+    // function: keep free_blk and free_by_size in sync
+    void insertFreeBlock(size_t addr, size_t size);
+    void eraseFreeBlock(size_t addr, size_t size);
   };
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "utils/exception.h"
+#include "utils/logger.h"
 #include <cassert>
 #include <functional>
 #include <iostream>
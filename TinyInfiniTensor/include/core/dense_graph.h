@@ -0,0 +1,92 @@
+#pragma once
+#include "core/operator.h"
+#include "core/tensor.h"
+#include <cstdint>
+
+namespace infini
+{
+
+    /**
+     * @brief A read-only, integer-indexed snapshot of the structure of a graph.
+     *
+     * Operators and tensors are numbered by their position in the operator and
+     * tensor lists of the graph they were built from, and every adjacency list
+     * is stored in one contiguous CSR array, so traversals neither lock weak
+     * references nor allocate. Edges are derived from the inputs and outputs
+     * of the operators in the graph only. A snapshot is invalidated by any
+     * change to the graph structure; GraphObj rebuilds it on demand.
+     */
+    class DenseGraph
+    {
+    public:
+        using Id = uint32_t;
+        static constexpr Id None = UINT32_MAX;
+
+        // A contiguous range of ids inside one of the CSR arrays.
+        class IdRange
+        {
+        public:
+            IdRange(const Id *first, const Id *last) : first(first), last(last) {}
+            const Id *begin() const { return first; }
+            const Id *end() const { return last; }
+            size_t size() const { return last - first; }
+            bool empty() const { return first == last; }
+            Id operator[](size_t i) const { return first[i]; }
+
+        private:
+            const Id *first, *last;
+        };
+
+        DenseGraph(const OpVec &ops, const TensorVec &tensors);
+
+        size_t numOps() const { return ops.size(); }
+        size_t numTensors() const { return tensors.size(); }
+        OperatorObj *getOp(Id op) const { return ops[op]; }
+        TensorObj *getTensor(Id tensor) const { return tensors[tensor].tensor; }
+        // Ids of objects of the graph, None for unknown ones.
+        Id opId(const OperatorObj *op) const;
+        Id tensorId(const TensorObj *tensor) const;
+
+        // Tensors used and produced by an operator, in argument order. Inputs
+        // that are not tensors of the graph are skipped.
+        IdRange inputs(Id op) const { return range(opInputs, op); }
+        IdRange outputs(Id op) const { return range(opOutputs, op); }
+        // Distinct producers and consumers of an operator, in id order.
+        IdRange predecessors(Id op) const { return range(opPredecessors, op); }
+        IdRange successors(Id op) const { return range(opSuccessors, op); }
+
+        // Producer of a tensor, None for graph inputs.
+        Id source(Id tensor) const { return tensors[tensor].source; }
+        // Consumers of a tensor, once per use, in id order.
+        IdRange targets(Id tensor) const { return range(tensorTargets, tensor); }
+        size_t bytes(Id tensor) const { return tensors[tensor].bytes; }
+
+    private:
+        struct TensorRecord
+        {
+            TensorObj *tensor;
+            Id source;
+            size_t bytes;
+        };
+
+        // Offsets into `ids`, one more than the number of rows.
+        struct Csr
+        {
+            vector<Id> offsets{0};
+            vector<Id> ids;
+        };
+
+        IdRange range(const Csr &csr, Id row) const
+        {
+            return IdRange(csr.ids.data() + csr.offsets[row],
+                           csr.ids.data() + csr.offsets[row + 1]);
+        }
+
+        vector<OperatorObj *> ops;
+        vector<TensorRecord> tensors;
+        std::unordered_map<const OperatorObj *, Id> opIds;
+        std::unordered_map<const TensorObj *, Id> tensorIds;
+        Csr opInputs, opOutputs, opPredecessors, opSuccessors, tensorTargets;
+    };
+
+} // namespace infini
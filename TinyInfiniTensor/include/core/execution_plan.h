@@ -0,0 +1,44 @@
+#pragma once
+#include "core/dense_graph.h"
+#include "core/kernel.h"
+
+namespace infini
+{
+
+    /**
+     * @brief A graph compiled for repeated runs: one prepared kernel step per
+     * operator, in graph order, and the dependencies between them.
+     *
+     * Kernels are looked up and their per-op state (attributes, shapes,
+     * strides, data pointers) is resolved once when the plan is built, so a
+     * run only walks a flat array of steps. A plan is tied to the structure,
+     * shapes and memory of the graph it was built from; GraphObj drops it on
+     * any change to those.
+     */
+    class ExecutionPlan
+    {
+    public:
+        using Id = DenseGraph::Id;
+
+        ExecutionPlan(const OpVec &ops, const DenseGraph &g,
+                      const RuntimeObj *runtime);
+
+        size_t size() const { return steps.size(); }
+
+        /**
+         * @brief Runs every step. With a single thread the steps run in
+         * order; otherwise a step is submitted to the shared thread pool as
+         * soon as the steps it depends on have finished.
+         */
+        void run() const;
+
+    private:
+        vector<Kernel::Step> steps;
+        // Successors of every step in CSR form: the data edges of the graph
+        // and the edges that order reuses of the same memory.
+        vector<Id> successorOffsets, successorIds;
+        vector<Id> nPredecessors;
+        vector<Id> roots;
+    };
+
+} // namespace infini
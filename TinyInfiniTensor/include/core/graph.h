@@ -1,13 +1,34 @@
 #pragma once
 #include "core/allocator.h"
+#include "core/dense_graph.h"
+#include "core/execution_plan.h"
+#include "core/memory_planner.h"
 #include "core/operator.h"
 #include "core/tensor.h"
+#include "core/view_planner.h"
 #include <algorithm>
 #include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace infini
 {
 
+    /**
+     * @brief Tie-breaking policy among operators that are ready at the same
+     * time during topological sorting.
+     */
+    enum class TopoOrder
+    {
+        // Lowest position in the current operator list first.
+        Stable,
+        // Operators that release the most bytes of intermediates first, then
+        // the lowest position.
+        MemoryAware,
+    };
+
     class GraphObj : public Object
     {
     protected:
@@ -25,38 +46,102 @@ namespace infini
         Tensor addTensor(Shape dim, DataType dtype = DataType::Float32);
         Tensor addTensor(const Tensor &tensor);
         TensorVec addTensor(const TensorVec &tensors);
-        void removeOperator(Operator op)
-        {
-            auto it = std::find(ops.begin(), ops.end(), op);
-            if (it != ops.end())
-                ops.erase(it);
-        }
-
-        void removeTensor(Tensor tensor)
-        {
-            auto it = std::find(tensors.begin(), tensors.end(), tensor);
-            if (it != tensors.end())
-                tensors.erase(it);
-        }
+        /**
+         * @brief Remove an operator or a tensor from the graph. Objects are
+         * found through a hash index. Inside optimize() the slot is only
+         * marked as removed and the lists are compacted once at the end;
+         * elsewhere the list is compacted immediately.
+         */
+        void removeOperator(Operator op);
+        void removeTensor(Tensor tensor);
 
         const TensorVec &getTensors() const { return tensors; }
         const OpVec &getOperators() const { return ops; }
+        /**
+         * @brief Get the tensor with the given Fuid, nullptr if none.
+         */
         Tensor getTensor(int) const;
+        bool hasOperator(const Operator &op) const;
+        bool hasTensor(const Tensor &tensor) const;
+
+        /**
+         * @brief Graph editing for rewrite rules. These keep the tensor
+         * source/targets and operator predecessor/successor links consistent.
+         */
+        // Make input `index` of `op` read `tensor`.
+        void replaceInput(const Operator &op, size_t index, const Tensor &tensor);
+        // Make every operator of the graph that reads `from` read `to`.
+        void replaceAllUses(const Tensor &from, const Tensor &to);
+        // Unlink `op` from its inputs, outputs and neighbours and remove it.
+        // Its output tensors stay in the graph without a source.
+        void disconnectOperator(const Operator &op);
+
+        /**
+         * @brief Integer-indexed view of the current graph structure. Ids are
+         * positions in getOperators() and getTensors(). The reference stays
+         * valid until the next change to the operators or tensors.
+         */
+        const DenseGraph &getDenseGraph() const;
+
+        /**
+         * @brief The graph compiled for the runtime, built on first use after
+         * dataMalloc(). It is dropped on every change to the structure, the
+         * shapes or the memory of the graph.
+         */
+        const ExecutionPlan &getExecutionPlan() const;
 
         /**
          * @brief Sort the nodes in topological order.
          * It returns true if the sorting is successful.
          * Otherwise false is returned, means that there are rings in the graph,
          * so the topological sorting fails.
+         * The order is deterministic: among the operators that are ready, the
+         * one chosen by `order` comes first. An already sorted graph is left
+         * untouched by the stable order.
          */
-        bool topo_sort();
+        bool topo_sort(TopoOrder order = TopoOrder::Stable);
 
+        /**
+         * @brief Apply the registered rewrite rules until none matches. A
+         * worklist holds the operators to visit; an operator is visited again
+         * only when a rewrite touched its neighbourhood. Operators whose
+         * inputs are all constant are first evaluated once and replaced by
+         * their constant outputs. Common subexpressions and dead code are
+         * eliminated before and after the rewrites.
+         */
         void optimize();
 
+        /**
+         * @brief Merge operators of the same type and attributes reading the
+         * same inputs into one, found by OperatorObj::hash(). Operators
+         * producing graph outputs are kept.
+         */
+        void eliminateCommonSubexpressions();
+
+        /**
+         * @brief Remove the operators that no output designated by
+         * setOutputs() depends on, and the tensors left unused, graph
+         * inputs included. Without designated outputs nothing is dead.
+         */
+        void eliminateDeadCode();
+
         void shape_infer();
 
+        /**
+         * @brief Plan the memory of every tensor and point them into the
+         * arena. Plans are cached by the shapes of the graph inputs, so
+         * planning again for shapes seen before reuses the plan and, if the
+         * arena did not move, the execution plan. The arena only grows.
+         */
         void dataMalloc();
 
+        /**
+         * @brief Give the graph inputs new shapes, in the order of
+         * getInputs(), then infer the other shapes and plan memory again.
+         * The data of every tensor is undefined afterwards.
+         */
+        void reshapeInputs(const vector<Shape> &shapes);
+
         /**
          * @brief Add an operator and create its outputs. Output tensor arguments
          * should be empty Refs (e.g., nullptr).
@@ -81,26 +166,44 @@ namespace infini
         }
 
         /**
-         * @brief Gets input tensors of this graph.
+         * @brief Gets input tensors of this graph: the tensors without a
+         * source, except constants.
          */
         inline TensorVec getInputs() const
         {
+            const auto &g = getDenseGraph();
             TensorVec ret;
-            for (const auto &t : tensors)
-                if (!t->getSource())
-                    ret.emplace_back(t);
+            for (size_t i = 0; i < tensors.size(); ++i)
+                if (g.source(i) == DenseGraph::None &&
+                    !tensors[i]->isConstant())
+                    ret.emplace_back(tensors[i]);
             return ret;
         }
 
+        /**
+         * @brief Designate the tensors read after a run, in place of the
+         * default of every tensor without consumers. They keep their memory
+         * for the whole run even if other operators read them, rewrites keep
+         * them, and they seed eliminateDeadCode().
+         */
+        void setOutputs(const TensorVec &outputs);
+        bool isDesignatedOutput(const Tensor &tensor) const
+        {
+            return designatedOutputFuids.count(tensor->getFuid()) > 0;
+        }
+
         /**
          * @brief Gets output tensors of this graph.
          */
         inline TensorVec getOutputs() const
         {
+            if (!designatedOutputs.empty())
+                return designatedOutputs;
+            const auto &g = getDenseGraph();
             TensorVec ret;
-            for (const auto &t : tensors)
-                if (t->getTargets().empty())
-                    ret.emplace_back(t);
+            for (size_t i = 0; i < tensors.size(); ++i)
+                if (g.targets(i).empty())
+                    ret.emplace_back(tensors[i]);
             return ret;
         }
 
@@ -112,10 +215,90 @@ namespace infini
          */
         void addOperatorAndConnect(const Operator &op);
 
+        /**
+         * @brief Relink `op` after its inputs changed from `oldInputs`.
+         */
+        void reconnectInputs(const Operator &op, const TensorVec &oldInputs);
+
+        /**
+         * @brief Evaluate `op` with its kernel if all of its inputs are
+         * constant, turning its outputs into constants and removing it.
+         * Outputs of the graph are left to be computed by `op`, and
+         * DequantizeLinear to the quantization rewrites.
+         */
+        bool foldConstant(const Operator &op, OpVec &affected);
+
         /**
          * @brief If the nodes is sorted in topological order.
          */
         bool sorted;
+
+        /**
+         * @brief Outputs set by setOutputs(), in order and by Fuid.
+         */
+        TensorVec designatedOutputs;
+        std::unordered_set<UidBaseType> designatedOutputFuids;
+
+        /**
+         * @brief Positions in `ops` by Guid and in `tensors` by Fuid.
+         */
+        std::unordered_map<UidBaseType, size_t> opIndex;
+        std::unordered_map<UidBaseType, size_t> tensorIndex;
+
+        /**
+         * @brief While set, removals leave nullptr tombstones in `ops` and
+         * `tensors` instead of shifting the lists.
+         */
+        bool deferCompaction = false;
+        size_t tombstones = 0;
+
+        void compact();
+        void reindexOperators(size_t from = 0);
+        void reindexTensors(size_t from = 0);
+
+        /**
+         * @brief Caches of getDenseGraph() and getExecutionPlan(), dropped on
+         * every structural change.
+         */
+        mutable std::unique_ptr<DenseGraph> dense;
+        mutable std::unique_ptr<ExecutionPlan> executionPlan;
+
+        /**
+         * @brief Plans made by dataMalloc(), by the shapes of the graph
+         * inputs. An execution plan is kept with the memory plan it was
+         * compiled for while other shapes are in use; it is only valid for
+         * the arena at `arena`.
+         */
+        struct ShapePlan
+        {
+            MemoryPlanner::Plan memory;
+            vector<ViewPlanner::View> views;
+            std::unique_ptr<ExecutionPlan> executionPlan;
+            void *arena = nullptr;
+        };
+        std::map<vector<Shape>, ShapePlan> shapePlans;
+        // Input shapes of the current memory plan, and its place in the arena.
+        optional<vector<Shape>> plannedInputShapes;
+        size_t arenaOffset = 0, arenaBytes = 0;
+
+        // Keep the current execution plan with the plan of its input shapes.
+        void stashExecutionPlan();
+
+        // Drop the caches that depend on the shapes.
+        void invalidateShapes()
+        {
+            stashExecutionPlan();
+            dense.reset();
+        }
+
+        // Drop every cache that depends on the structure of the graph.
+        void invalidateViews()
+        {
+            dense.reset();
+            executionPlan.reset();
+            shapePlans.clear();
+            plannedInputShapes.reset();
+        }
     };
 
 } // namespace infini
@@ -13,6 +13,10 @@ namespace infini
     class Kernel
     {
     public:
+        // A run of one operator with everything that does not depend on the
+        // tensor data resolved up front.
+        using Step = std::function<void()>;
+
         Kernel() {}
         virtual ~Kernel() {}
 
@@ -21,6 +25,19 @@ namespace infini
          */
         virtual void compute(const Operator &op,
                              const RuntimeObj *context) const = 0;
+
+        /**
+         * @brief Resolves the attributes, shapes and data pointers of an op
+         * once, for an execution plan that runs it many times. The step is
+         * valid while the shapes and the memory of the op's tensors stay the
+         * same. By default the step simply calls compute().
+         */
+        virtual Step prepare(const Operator &op,
+                             const RuntimeObj *context) const
+        {
+            return [this, op, context]
+            { compute(op, context); };
+        }
     };
 
     class KernelRegistry
@@ -63,6 +80,10 @@ namespace infini
         {
             return kernels.at(kernelAttrs);
         }
+        bool hasKernel(const KernelAttrs &kernelAttrs) const
+        {
+            return kernels.find(kernelAttrs) != kernels.end();
+        }
     };
 
     class CpuKernelWithoutConfig : public Kernel
@@ -72,6 +93,41 @@ namespace infini
                              const RuntimeObj *context) const = 0;
     };
 
+    // Integer parameters of a kernel variant, e.g. tile sizes.
+    using TuneConfig = vector<int>;
+
+    /**
+     * @brief A kernel with several configurations. The configuration used
+     * for an op is chosen by PerfEngine, which benchmarks the candidates the
+     * first time an op with a new tune key is prepared.
+     */
+    class TunableKernel : public Kernel
+    {
+    public:
+        /**
+         * @brief Candidate configurations for an op, the default first.
+         * Candidates that behave the same for the op's shapes should be left
+         * out; a single candidate is used without benchmarking.
+         */
+        virtual vector<TuneConfig> getTuneConfigs(const Operator &op) const = 0;
+        /**
+         * @brief Identifies the ops that share a best configuration, usually
+         * the op type, data type, shapes and attributes.
+         */
+        virtual string getTuneKey(const Operator &op) const = 0;
+        virtual Step prepare(const Operator &op, const TuneConfig &config,
+                             const RuntimeObj *context) const = 0;
+
+        // Prepares with the configuration chosen by PerfEngine.
+        Step prepare(const Operator &op,
+                     const RuntimeObj *context) const override;
+        void compute(const Operator &op,
+                     const RuntimeObj *context) const override
+        {
+            prepare(op, context)();
+        }
+    };
+
 } // namespace infini
 
 #define _REGISTER_KERNEL_1(device, opType, kernel, name, cnt)                 \
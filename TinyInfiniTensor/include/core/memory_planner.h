@@ -0,0 +1,64 @@
+#pragma once
+#include "core/allocator.h"
+
+namespace infini
+{
+
+    /**
+     * @brief Plans the placement of tensors in one arena from their lifetimes.
+     *
+     * Operators are numbered by their position in topological order. A buffer
+     * is live from the step of the operator that defines it to the step of its
+     * last consumer, both inclusive, and two buffers may share memory only if
+     * their lifetimes are disjoint. Several placement strategies are available;
+     * `plan` without a strategy tries all of them and keeps the lowest peak.
+     */
+    class MemoryPlanner
+    {
+    public:
+        struct Buffer
+        {
+            size_t bytes;
+            size_t firstDef;
+            size_t lastUse;
+        };
+
+        enum class Strategy
+        {
+            // Replays allocations and frees in execution order through an
+            // Allocator, the same way a runtime allocator would see them.
+            Sequential,
+            // Places the largest buffers first, each at the lowest offset not
+            // used by a buffer it overlaps in time.
+            BySize,
+            // Places the longest living buffers first, same placement rule.
+            ByLifetime,
+        };
+
+        struct Plan
+        {
+            Strategy strategy;
+            size_t peak;
+            // Offset of every buffer, in the order they were given.
+            vector<size_t> offsets;
+        };
+
+        MemoryPlanner(Runtime runtime, size_t alignment)
+            : runtime(runtime), alignment(alignment){};
+
+        Plan plan(const vector<Buffer> &buffers) const;
+        Plan plan(const vector<Buffer> &buffers, Strategy strategy) const;
+
+        static const char *toString(Strategy strategy);
+
+    private:
+        Runtime runtime;
+        size_t alignment;
+
+        size_t getAlignedSize(size_t size) const;
+        Plan planSequential(const vector<Buffer> &buffers) const;
+        Plan planGreedy(const vector<Buffer> &buffers,
+                        const vector<size_t> &order) const;
+    };
+
+} // namespace infini
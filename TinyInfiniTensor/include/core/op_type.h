@@ -24,6 +24,9 @@ namespace infini
             Relu,
             Sub,
             Transpose,
+            FusedElementWise,
+            QuantizeLinear,
+            DequantizeLinear,
 
         } type;
 
@@ -46,7 +46,11 @@ namespace infini
             IT_ASSERT(i < outputs.size(), "Index exceeded");
             return outputs.at(i);
         }
-        OpVec getPredecessors() const { std::cout << "getPred" << std::endl; return wrefs_to_refs(predecessors); }
+        OpVec getPredecessors() const
+        {
+            IT_LOG_TRACE("predecessors of op " << getGuid());
+            return wrefs_to_refs(predecessors);
+        }
         OpVec getSuccessors() const { return wrefs_to_refs(successors); }
         OpType getOpType() const { return type; }
         // HACK: set correct data type
@@ -54,6 +58,30 @@ namespace infini
         DataType getOutDType() const { return getOutput()->getDType(); }
         virtual int numInputs() const = 0;
         virtual int numOutputs() const = 0;
+        /**
+         * @brief Whether the kernel reads input `i` through its strides, so
+         * that the input may be a non-contiguous view (see
+         * TensorObj::getStrides). Kernels assume contiguous inputs otherwise.
+         */
+        virtual bool acceptsStridedInput(int i) const { return false; }
+        /**
+         * @brief Whether the kernel stays correct when output 0 is written
+         * over input `i`, provided both have the same shape and data type.
+         * The memory planner then may run the operator in place.
+         */
+        virtual bool canOverwriteInput(int i) const { return false; }
+
+        /**
+         * @brief The type and the attributes of the operator as integers.
+         * Operators with equal vectors compute the same function of their
+         * inputs, so operators with attributes must append them.
+         */
+        virtual vector<int> getOpAttrVector() const;
+        /**
+         * @brief Structural hash over getOpAttrVector() and the Fuids of
+         * the inputs. Equal operators on the same inputs hash alike.
+         */
+        size_t hash() const;
 
         /**
          * @brief Clone this operator and replace its inputs and outputs.
@@ -0,0 +1,62 @@
+#pragma once
+#include "core/kernel.h"
+#include <atomic>
+#include <mutex>
+
+namespace infini
+{
+
+    /**
+     * @brief Tuning results of the tunable kernels, by tune key.
+     *
+     * The first time an op with an unknown key is prepared, every candidate
+     * configuration of its kernel is run on the op's tensors and the fastest
+     * one is recorded. Records can be saved to and loaded from a JSON file.
+     * If the environment variable INFINI_TUNE_CACHE names a file, it is
+     * loaded on first use and rewritten after each new tuning result.
+     * INFINI_TUNE=0 disables benchmarking; unknown keys then use the default
+     * configuration.
+     */
+    class PerfEngine
+    {
+    public:
+        struct Record
+        {
+            TuneConfig config;
+            // Best measured time of one run, in milliseconds.
+            double time;
+        };
+
+        static PerfEngine &getInstance();
+
+        /**
+         * @brief The configuration of `kernel` for `op`: a recorded one if it
+         * is still a candidate, otherwise the result of tuning now. Records
+         * are kept per number of threads of the shared pool.
+         */
+        TuneConfig getConfig(const TunableKernel &kernel, const Operator &op,
+                             const RuntimeObj *context);
+
+        optional<Record> getRecord(const string &key) const;
+        void setRecord(const string &key, const Record &record);
+        size_t size() const;
+        void clear();
+
+        bool isTuningEnabled() const { return tuning; }
+        void setTuningEnabled(bool enabled) { tuning = enabled; }
+
+        // Merges the records of a file into this engine, returns false if
+        // the file cannot be read or parsed.
+        bool load(const string &path);
+        bool save(const string &path) const;
+
+    private:
+        PerfEngine();
+
+        mutable std::mutex mutex;
+        std::map<string, Record> records;
+        string cachePath;
+        std::atomic<bool> tuning{true};
+    };
+
+} // namespace infini
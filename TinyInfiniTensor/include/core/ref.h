@@ -34,13 +34,11 @@ std::vector<WRef<T>> refs_to_wrefs(const std::vector<Ref<T>> &refs) {
 
 template <typename T>
 std::vector<Ref<T>> wrefs_to_refs(const std::vector<WRef<T>> &wrefs) {
-    std::cout << "get ref from wref" << std::endl;
+    IT_LOG_TRACE("converting " << wrefs.size() << " weak references");
     std::vector<Ref<T>> refs;
-    for (const auto &wref : wrefs){
-        std::cout << "converting: " << std::endl;
+    refs.reserve(wrefs.size());
+    for (const auto &wref : wrefs)
         refs.emplace_back(wref);
-    }
-    std::cout << "converted" << std::endl;
     return refs;
 }
 
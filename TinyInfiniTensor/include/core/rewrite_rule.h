@@ -0,0 +1,66 @@
+#pragma once
+#include "core/common.h"
+#include "core/op_type.h"
+#include "core/operator.h"
+
+namespace infini
+{
+
+    class GraphObj;
+
+    /**
+     * @brief A graph rewrite anchored on one operator.
+     *
+     * A rule inspects `op` and its producer/consumer edges and, if it matches,
+     * edits the graph through the GraphObj editing methods and returns true.
+     * Operators whose neighbourhood changed, including newly created ones,
+     * must be appended to `affected` so that the rewrite engine visits them
+     * again. Every successful rewrite must make the graph smaller or otherwise
+     * bring it closer to a fixpoint.
+     */
+    using RewriteRule =
+        std::function<bool(GraphObj &graph, const Operator &op, OpVec &affected)>;
+
+    class RewriteRuleRegistry
+    {
+    public:
+        using RuleRecord = pair<string, RewriteRule>; // name, rule
+
+    private:
+        std::map<OpType::underlying_t, vector<RuleRecord>> rules;
+
+    public:
+        static RewriteRuleRegistry &getInstance()
+        {
+            static RewriteRuleRegistry instance;
+            return instance;
+        }
+        bool registerRule(OpType opType, const string &name, RewriteRule rule)
+        {
+            rules[opType.underlying()].emplace_back(name, std::move(rule));
+            return true;
+        }
+        /**
+         * @brief Rules anchored on operators of `opType`, in registration
+         * order.
+         */
+        const vector<RuleRecord> &getRules(OpType opType) const
+        {
+            static const vector<RuleRecord> none;
+            auto it = rules.find(opType.underlying());
+            return it == rules.end() ? none : it->second;
+        }
+    };
+
+} // namespace infini
+
+#define _REGISTER_REWRITE_RULE_1(opType, rule, name, cnt)                     \
+    namespace infini                                                          \
+    {                                                                         \
+        static const bool _CAT(_register_rewrite_rule_, cnt) =                \
+            RewriteRuleRegistry::getInstance().registerRule(opType, name,     \
+                                                            rule);            \
+    }
+
+#define REGISTER_REWRITE_RULE(opType, rule, name) \
+    _REGISTER_REWRITE_RULE_1(opType, rule, name, __COUNTER__)
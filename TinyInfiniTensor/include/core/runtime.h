@@ -2,6 +2,8 @@
 #include "core/common.h"
 #include "core/op_type.h"
 #include "core/ref.h"
+#include <mutex>
+#include <unordered_map>
 
 namespace infini
 {
@@ -40,6 +42,11 @@ namespace infini
     virtual void run(const Graph &graph) const = 0;
     virtual void *alloc(size_t size) = 0;
     virtual void dealloc(void *ptr) = 0;
+    // Alignment of the memory returned by alloc(), which the memory planner
+    // also keeps for every tensor placed inside it.
+    virtual size_t getAlignment() const { return sizeof(uint64_t); }
+
+    Device getDevice() const { return device; }
 
     bool isCpu() const
     {
@@ -49,9 +56,28 @@ namespace infini
     virtual string toString() const = 0;
   };
 
+  /**
+   * @brief Runtime on the host CPU.
+   *
+   * Memory is aligned to 64 bytes by default, a cache line and an AVX-512
+   * vector. Allocations of at least `hugePageThreshold` bytes are mapped
+   * directly and, where supported, advised to use transparent huge pages.
+   * Memory is not zeroed unless requested: its pages are only faulted in
+   * when first written.
+   */
   class NativeCpuRuntimeObj : public RuntimeObj
   {
+    size_t alignment = 64;
+    bool zeroInit = false;
+    bool hugePages = true;
+    // Blocks obtained from mmap and their sizes, as they are released
+    // differently.
+    std::mutex mappedMutex;
+    std::unordered_map<void *, size_t> mapped;
+
   public:
+    static constexpr size_t hugePageThreshold = size_t(2) << 20;
+
     NativeCpuRuntimeObj() : RuntimeObj(Device::CPU) {}
 
     static Ref<NativeCpuRuntimeObj> &getInstance()
@@ -64,6 +90,14 @@ namespace infini
     void run(const Graph &graph) const override;
     void *alloc(size_t size) override;
     string toString() const override;
+
+    size_t getAlignment() const override { return alignment; }
+    // A power of two, at least sizeof(uint64_t). Affects allocators, and
+    // so graphs, created afterwards.
+    void setAlignment(size_t bytes);
+    // Zero new allocations, for callers that read memory before writing it.
+    void setZeroInit(bool enable) { zeroInit = enable; }
+    void setHugePages(bool enable) { hugePages = enable; }
   };
 
 } // namespace infini
@@ -28,6 +28,14 @@ namespace infini
     private:
         Shape shape;
         size_t _size; // Cache of Π(shape).
+        // Element step of every dimension in memory. Row-major unless the
+        // tensor is a view.
+        vector<size_t> strides;
+        // Tensor owning the memory this tensor is a view into, if any.
+        Ref<TensorObj> viewBase;
+        // Memory of a constant tensor, owned by the tensor itself rather than
+        // by the arena of its graph.
+        std::shared_ptr<void> constant;
         Fuid fuid;    // Cloned tensors share the same id. Tensors constructed from
                       // scratch have a new id.
 
@@ -48,6 +56,29 @@ namespace infini
             std::function<void(void *, size_t, DataType)> const &generator) const;
 
         void setDataBlob(const Blob &blob);
+        /**
+         * @brief Make this tensor a constant, e.g. a weight: it gets memory
+         * of its own, filled once by `generator`, which graphs keep across
+         * dataMalloc() and never write. A constant is not a graph input.
+         */
+        void setConstant(
+            std::function<void(void *, size_t, DataType)> const &generator);
+        bool isConstant() const { return constant != nullptr; }
+        // The memory of a constant tensor.
+        Blob getConstantBlob() const;
+        /**
+         * @brief Make this tensor a view into the memory of `base`, starting
+         * `offset` elements into it and laid out with `strides`. `base` must
+         * own its memory. The view is dropped by the next setDataBlob().
+         */
+        void setView(const Ref<TensorObj> &base, size_t offset,
+                     vector<size_t> strides);
+        Ref<TensorObj> getViewBase() const { return viewBase; }
+        const vector<size_t> &getStrides() const { return strides; }
+        // True for the row-major layout. Data of other tensors is only
+        // meaningful when read through their strides.
+        bool isContiguous() const;
+        static vector<size_t> contiguousStrides(const Shape &shape);
 
         void printData() const;
         bool equalData(const Tensor &rhs, double relativeError = 1e-6) const;
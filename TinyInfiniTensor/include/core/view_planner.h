@@ -0,0 +1,42 @@
+#pragma once
+#include "core/dense_graph.h"
+
+namespace infini
+{
+
+    /**
+     * @brief Chooses the tensors that need no memory of their own because
+     * they can live inside the memory of another tensor.
+     *
+     * - An input of a Concat whose slice of the output is contiguous (all
+     *   output dimensions before the axis are 1) is placed directly in that
+     *   slice, so the Concat has nothing left to copy for it. Constants are
+     *   copied.
+     * - The output of a Transpose becomes a strided view of its input when it
+     *   is not a graph output and all its consumers accept strided inputs,
+     *   which turns the Transpose into a no-op.
+     * - An input that dies at an operator able to overwrite it (see
+     *   OperatorObj::canOverwriteInput) is placed in the memory of the
+     *   output, so that the operator runs in place.
+     *
+     * Views of views are resolved to the tensor that owns the memory.
+     */
+    class ViewPlanner
+    {
+    public:
+        struct View
+        {
+            // Tensor owning the memory, None if the tensor is not a view.
+            DenseGraph::Id base = DenseGraph::None;
+            // Element offset into the base and element strides.
+            size_t offset = 0;
+            vector<size_t> strides;
+        };
+
+        // One entry per tensor of `g`, by tensor id. `outputs` flags the
+        // tensors read after the run besides those without consumers.
+        static vector<View> plan(const DenseGraph &g,
+                                 const vector<bool> &outputs);
+    };
+
+} // namespace infini
@@ -0,0 +1,150 @@
+#pragma once
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "utils/cpu_isa.h"
+#include "utils/half.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace infini {
+
+/**
+ * @brief Row kernels of one element type, vectorized for one ISA.
+ *
+ * Binary kernels compute out[i] = a[i * sa] op b[i * sb] for i < n, where the
+ * steps `sa` and `sb` are 0 (broadcast) or 1, matching the rows produced by
+ * BroadcastIterator. Clip computes min(max(in[i], lo), hi) and keeps NaNs.
+ * All kernels allow `out` to be the same array as an input read with step 1,
+ * so that operators can run in place.
+ */
+template <typename T> struct SimdOps {
+    using Binary = void (*)(T *out, const T *a, size_t sa, const T *b,
+                            size_t sb, size_t n);
+    using Unary = void (*)(T *out, const T *in, size_t n);
+    using Clip = void (*)(T *out, const T *in, size_t n, T lo, T hi);
+
+    Binary add, sub, mul, div;
+    Unary relu;
+    Clip clip;
+};
+
+// Widening and narrowing kernels of one 16-bit float format.
+struct HalfCast {
+    void (*widen)(float *out, const uint16_t *in, size_t n);
+    void (*narrow)(uint16_t *out, const float *in, size_t n);
+};
+
+/**
+ * @brief Element type conversions to and from float, vectorized for one ISA.
+ *
+ * Each kernel converts `n` contiguous elements with the semantics of the
+ * scalar conversions below, so that every ISA produces the same bits. 16-bit
+ * floats are stored as uint16_t.
+ */
+struct CastOps {
+    void (*f32ToI32)(int32_t *out, const float *in, size_t n);
+    void (*i32ToF32)(float *out, const int32_t *in, size_t n);
+    void (*f32ToF16)(uint16_t *out, const float *in, size_t n);
+    void (*f16ToF32)(float *out, const uint16_t *in, size_t n);
+    void (*f32ToBf16)(uint16_t *out, const float *in, size_t n);
+    void (*bf16ToF32)(float *out, const uint16_t *in, size_t n);
+
+    HalfCast f16() const { return {f16ToF32, f32ToF16}; }
+    HalfCast bf16() const { return {bf16ToF32, f32ToBf16}; }
+};
+
+// Float to integer conversion truncates toward zero and saturates to the
+// range of `I`; NaN converts to 0.
+template <typename I> inline I float_to_int(float x) {
+    using limits = std::numeric_limits<I>;
+    if (std::isnan(x))
+        return 0;
+    if (x <= float(limits::min()))
+        return limits::min();
+    if (x >= float(limits::max()))
+        return limits::max();
+    return I(x);
+}
+
+template <typename I> inline float int_to_float(I x) { return float(x); }
+
+struct SimdKernels {
+    CpuIsa isa;
+    SimdOps<float> f32;
+    SimdOps<uint32_t> u32;
+    // out[j * ldOut + i] = in[i * ldIn + j] for i < rows, j < cols, on any
+    // 32-bit (16-bit) elements, using register tile transposes.
+    void (*transpose32)(const uint32_t *in, size_t ldIn, uint32_t *out,
+                        size_t ldOut, size_t rows, size_t cols);
+    void (*transpose16)(const uint16_t *in, size_t ldIn, uint16_t *out,
+                        size_t ldOut, size_t rows, size_t cols);
+    CastOps cast;
+};
+
+// Kernels for the best ISA of the running CPU, selected once on first use.
+const SimdKernels &get_simd_kernels();
+// Kernels for a specific ISA, or nullptr if this CPU or build lacks it.
+const SimdKernels *get_simd_kernels(CpuIsa isa);
+
+// Per-ISA tables, defined in src/kernels/cpu/simd/.
+const SimdKernels &get_simd_kernels_scalar();
+const SimdKernels *get_simd_kernels_sse41();
+const SimdKernels *get_simd_kernels_avx2();
+const SimdKernels *get_simd_kernels_avx512();
+
+/**
+ * @brief Runs float kernels on rows of a 16-bit float format.
+ *
+ * Blocks of each row are widened into float buffers, computed and narrowed
+ * back, so that results are rounded once as if computed in float. Steps and
+ * aliasing are those of the wrapped kernels.
+ */
+struct HalfRows {
+    static constexpr size_t block = 256;
+    HalfCast cast;
+
+    void binary(SimdOps<float>::Binary kernel, uint16_t *out,
+                const uint16_t *a, size_t sa, const uint16_t *b, size_t sb,
+                size_t n) const {
+        float fa[block], fb[block], fout[block];
+        for (size_t i = 0; i < n; i += block) {
+            size_t m = n - i < block ? n - i : block;
+            cast.widen(fa, a + i * sa, sa ? m : 1);
+            cast.widen(fb, b + i * sb, sb ? m : 1);
+            kernel(fout, fa, sa, fb, sb, m);
+            cast.narrow(out + i, fout, m);
+        }
+    }
+
+    // `f(out, in, n)` computes a float row.
+    template <typename F>
+    void unary(uint16_t *out, const uint16_t *in, size_t n, const F &f) const {
+        float fin[block], fout[block];
+        for (size_t i = 0; i < n; i += block) {
+            size_t m = n - i < block ? n - i : block;
+            cast.widen(fin, in + i, m);
+            f(fout, fin, m);
+            cast.narrow(out + i, fout, m);
+        }
+    }
+};
+
+template <typename T> struct has_simd_ops : std::false_type {};
+template <> struct has_simd_ops<float> : std::true_type {};
+template <> struct has_simd_ops<uint32_t> : std::true_type {};
+
+template <typename T> const SimdOps<T> &get_simd_ops();
+template <> inline const SimdOps<float> &get_simd_ops<float>() {
+    return get_simd_kernels().f32;
+}
+template <> inline const SimdOps<uint32_t> &get_simd_ops<uint32_t>() {
+    return get_simd_kernels().u32;
+}
+
+} // namespace infini
+
+#endif
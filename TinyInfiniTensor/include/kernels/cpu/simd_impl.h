@@ -0,0 +1,175 @@
+#pragma once
+#ifndef SIMD_IMPL_H
+#define SIMD_IMPL_H
+
+#include "kernels/cpu/simd.h"
+
+// Generic row loops shared by the per-ISA translation units in
+// src/kernels/cpu/simd/. Each unit includes this header inside its own
+// `#pragma GCC target` region. Everything here lives in an anonymous
+// namespace, including the operator functors and their scalar tails, so
+// every instantiation is local to the unit and compiled for its ISA only;
+// the linker can never substitute one unit's copy for another's.
+//
+// A traits type `O` provides `T`, `V`, the lane count `W` and the static
+// functions load, store, set1, add, sub, mul, div, max and min, where
+// max(a, b) is `a > b ? a : b` and min(a, b) is `a < b ? a : b` lane-wise.
+// Traits used for transposes also provide the tile width `TW` and
+// transposeTile, which transposes one TW x TW tile of 32-bit elements, or of
+// the element type the transpose is instantiated for.
+// Cast traits provide the lane count `W` and one static function per CastOps
+// member converting W elements at a time.
+
+namespace infini {
+namespace simd_impl {
+namespace {
+
+struct AddOp {
+    template <class O> static typename O::V vec(typename O::V a,
+                                                typename O::V b) {
+        return O::add(a, b);
+    }
+    template <typename T> static T scalar(T a, T b) { return a + b; }
+};
+
+struct SubOp {
+    template <class O> static typename O::V vec(typename O::V a,
+                                                typename O::V b) {
+        return O::sub(a, b);
+    }
+    template <typename T> static T scalar(T a, T b) { return a - b; }
+};
+
+struct MulOp {
+    template <class O> static typename O::V vec(typename O::V a,
+                                                typename O::V b) {
+        return O::mul(a, b);
+    }
+    template <typename T> static T scalar(T a, T b) { return a * b; }
+};
+
+struct DivOp {
+    template <class O> static typename O::V vec(typename O::V a,
+                                                typename O::V b) {
+        return O::div(a, b);
+    }
+    template <typename T> static T scalar(T a, T b) { return (T)(a / b); }
+};
+
+template <class O, class Op>
+void binary(typename O::T *out, const typename O::T *a, size_t sa,
+            const typename O::T *b, size_t sb, size_t n) {
+    using T = typename O::T;
+    constexpr size_t W = O::W;
+    size_t i = 0;
+    if (sa && sb) {
+        for (; i + W <= n; i += W)
+            O::store(out + i,
+                     Op::template vec<O>(O::load(a + i), O::load(b + i)));
+    } else if (sa) {
+        auto vb = O::set1(*b);
+        for (; i + W <= n; i += W)
+            O::store(out + i, Op::template vec<O>(O::load(a + i), vb));
+    } else if (sb) {
+        auto va = O::set1(*a);
+        for (; i + W <= n; i += W)
+            O::store(out + i, Op::template vec<O>(va, O::load(b + i)));
+    } else {
+        T v = Op::scalar(*a, *b);
+        auto vv = O::set1(v);
+        for (; i + W <= n; i += W)
+            O::store(out + i, vv);
+    }
+    for (; i < n; ++i)
+        out[i] = Op::scalar(a[i * sa], b[i * sb]);
+}
+
+template <class O>
+void relu(typename O::T *out, const typename O::T *in, size_t n) {
+    using T = typename O::T;
+    constexpr size_t W = O::W;
+    auto zero = O::set1(T(0));
+    size_t i = 0;
+    for (; i + W <= n; i += W)
+        O::store(out + i, O::max(O::load(in + i), zero));
+    for (; i < n; ++i)
+        out[i] = in[i] > T(0) ? in[i] : T(0);
+}
+
+template <class O>
+void clip(typename O::T *out, const typename O::T *in, size_t n,
+          typename O::T lo, typename O::T hi) {
+    constexpr size_t W = O::W;
+    auto vlo = O::set1(lo), vhi = O::set1(hi);
+    size_t i = 0;
+    for (; i + W <= n; i += W)
+        O::store(out + i, O::min(vhi, O::max(vlo, O::load(in + i))));
+    for (; i < n; ++i)
+        out[i] = in[i] < lo ? lo : in[i] > hi ? hi : in[i];
+}
+
+template <class O, typename E = uint32_t>
+void transpose(const E *in, size_t ldIn, E *out, size_t ldOut, size_t rows,
+               size_t cols) {
+    constexpr size_t TW = O::TW;
+    // Column blocks keep both the source rows and the destination rows of a
+    // strip of tiles resident in L1.
+    constexpr size_t colBlock = 64;
+    size_t fullRows = rows / TW * TW, fullCols = cols / TW * TW;
+    for (size_t jb = 0; jb < fullCols; jb += colBlock) {
+        size_t je = jb + colBlock < fullCols ? jb + colBlock : fullCols;
+        for (size_t i = 0; i < fullRows; i += TW)
+            for (size_t j = jb; j < je; j += TW)
+                O::transposeTile(in + i * ldIn + j, ldIn, out + j * ldOut + i,
+                                 ldOut);
+    }
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = i < fullRows ? fullCols : 0; j < cols; ++j)
+            out[j * ldOut + i] = in[i * ldIn + j];
+}
+
+// Converts full vectors with `Vec` and the tail with the scalar conversion.
+template <size_t W, auto Vec, auto Elem, typename Out, typename In>
+void convert(Out *out, const In *in, size_t n) {
+    size_t i = 0;
+    for (; i + W <= n; i += W)
+        Vec(out + i, in + i);
+    for (; i < n; ++i)
+        out[i] = Elem(in[i]);
+}
+
+// Fill a cast table with the loops instantiated for cast traits `C`. ISAs
+// without half precision conversions keep them unset for the caller.
+template <class C, bool withHalf = true> CastOps make_cast_ops() {
+    constexpr size_t W = C::W;
+    CastOps ops{};
+    ops.f32ToI32 = convert<W, C::f32ToI32, float_to_int<int32_t>>;
+    ops.i32ToF32 = convert<W, C::i32ToF32, int_to_float<int32_t>>;
+    if constexpr (withHalf) {
+        ops.f32ToF16 = convert<W, C::f32ToF16, float_to_half>;
+        ops.f16ToF32 = convert<W, C::f16ToF32, half_to_float>;
+    }
+    ops.f32ToBf16 = convert<W, C::f32ToBf16, float_to_bfloat16>;
+    ops.bf16ToF32 = convert<W, C::bf16ToF32, bfloat16_to_float>;
+    return ops;
+}
+
+// Fill a table with the loops instantiated for traits `O`. Element types
+// without a vector division keep `div` unset for the caller to fill in.
+template <class O, bool withDiv = true> SimdOps<typename O::T> make_ops() {
+    SimdOps<typename O::T> ops{};
+    ops.add = binary<O, AddOp>;
+    ops.sub = binary<O, SubOp>;
+    ops.mul = binary<O, MulOp>;
+    if constexpr (withDiv)
+        ops.div = binary<O, DivOp>;
+    ops.relu = relu<O>;
+    ops.clip = clip<O>;
+    return ops;
+}
+
+} // namespace
+} // namespace simd_impl
+} // namespace infini
+
+#endif
@@ -28,6 +28,8 @@ namespace infini
     std::string toString() const override;
     int numInputs() const override { return 2; }
     int numOutputs() const override { return 1; }
+    bool acceptsStridedInput(int i) const override { return true; }
+    bool canOverwriteInput(int i) const override { return true; }
     };
 
 #define DEFINE_ELEMENT_WISE_OBJ(prefix, type)                    \
@@ -0,0 +1,67 @@
+#pragma once
+#include "core/operator.h"
+#include "operators/unary.h"
+
+namespace infini
+{
+  /**
+   * @brief A chain of element-wise operators evaluated in a single pass.
+   *
+   * The chain is kept as a small program over numbered slots: slots
+   * [0, numInputs()) are the inputs and slot numInputs() + i is the result of
+   * instruction i. The result of the last instruction is the output. Inputs
+   * broadcast to the output shape; every intermediate result has the output
+   * shape, so the program is evaluated independently for every output element.
+   */
+  class FusedElementWiseObj : public OperatorObj
+  {
+  public:
+    struct Instruction
+    {
+      // One of Add, Sub, Mul, Div, Relu, Clip or Cast.
+      OpType type;
+      // Operand slots, `b` is -1 for unary instructions.
+      int a, b;
+      // Data type of the result.
+      DataType dtype;
+      // Bounds of Clip.
+      std::optional<float> min, max;
+      // Conversion of Cast.
+      CastType castType;
+    };
+
+    /**
+     * @brief Construct a new FusedElementWise object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param inputs The tensors read by the program, without duplicates.
+     * @param output The output tensor.
+     * @param program The instructions, in evaluation order.
+     */
+    FusedElementWiseObj(GraphObj *graph, TensorVec inputs, Tensor output,
+                        vector<Instruction> program);
+    OP_CLONE(FusedElementWiseObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    vector<DataType> inferDataType(const TensorVec &inputs) const override;
+
+    std::string toString() const override;
+    vector<int> getOpAttrVector() const override;
+    int numInputs() const override { return inputs.size(); }
+    int numOutputs() const override { return 1; }
+    const vector<Instruction> &getProgram() const { return program; }
+
+    /**
+     * @brief Whether `op` can become part of a fused chain: a binary
+     * element-wise operator, Relu or Clip on Float32 or UInt32, a Cast
+     * between Float32 and Int32, or a fused chain.
+     */
+    static bool isFusible(const Operator &op);
+    /**
+     * @brief The program of a fusible operator, over its own inputs.
+     */
+    static vector<Instruction> programOf(const Operator &op);
+
+  private:
+    vector<Instruction> program;
+  };
+} // namespace infini
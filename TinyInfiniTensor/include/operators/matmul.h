@@ -43,10 +43,14 @@ namespace infini
         OP_CLONE(MatmulObj);
 
         std::string toString() const override;
+        vector<int> getOpAttrVector() const override;
         optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+        // Int8 products are accumulated and returned in Int32.
+        vector<DataType> inferDataType(const TensorVec &inputs) const override;
 
         int numInputs() const override { return inputs.size(); }
         int numOutputs() const override { return 1; }
+        bool acceptsStridedInput(int i) const override { return true; }
 
         bool getTransA() const { return transA; }
         bool getTransB() const { return transB; }
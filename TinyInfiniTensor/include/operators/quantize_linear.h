@@ -0,0 +1,87 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini {
+/**
+ * @brief Parameters of linear quantization, real = scale * (q - zeroPoint).
+ *
+ * A single scale and zero point cover the whole tensor. Otherwise there is
+ * one of each per index of dimension `axis` (per-channel quantization).
+ */
+struct QuantParams {
+    vector<float> scales;
+    vector<int> zeroPoints;
+    int axis = 1;
+
+    bool isPerTensor() const { return scales.size() == 1; }
+    bool operator==(const QuantParams &rhs) const {
+        return scales == rhs.scales && zeroPoints == rhs.zeroPoints &&
+               (isPerTensor() || axis == rhs.axis);
+    }
+};
+
+/**
+ * @brief Quantize a Float32 tensor to Int8 or UInt8, rounding half to even
+ * and saturating, as ONNX QuantizeLinear.
+ */
+class QuantizeLinearObj : public OperatorObj {
+    QuantParams params;
+    DataType outputType;
+
+  public:
+    /**
+     * @brief Construct a new QuantizeLinear object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The Float32 tensor to quantize.
+     * @param output The quantized tensor.
+     * @param params Scales and zero points, per tensor or per channel. A
+     * negative axis counts from the last dimension.
+     * @param outputType Int8 or UInt8.
+     */
+    QuantizeLinearObj(GraphObj *graph, Tensor input, Tensor output,
+                      QuantParams params,
+                      DataType outputType = DataType::Int8);
+    OP_CLONE(QuantizeLinearObj);
+
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    vector<DataType> inferDataType(const TensorVec &inputs) const override;
+
+    std::string toString() const override;
+    vector<int> getOpAttrVector() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    const QuantParams &getParams() const { return params; }
+};
+
+/**
+ * @brief Dequantize an Int8, UInt8 or Int32 tensor to Float32, as ONNX
+ * DequantizeLinear.
+ */
+class DequantizeLinearObj : public OperatorObj {
+    QuantParams params;
+
+  public:
+    /**
+     * @brief Construct a new DequantizeLinear object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The quantized tensor.
+     * @param output The Float32 tensor.
+     * @param params Scales and zero points, per tensor or per channel. A
+     * negative axis counts from the last dimension.
+     */
+    DequantizeLinearObj(GraphObj *graph, Tensor input, Tensor output,
+                        QuantParams params);
+    OP_CLONE(DequantizeLinearObj);
+
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    vector<DataType> inferDataType(const TensorVec &inputs) const override;
+
+    std::string toString() const override;
+    vector<int> getOpAttrVector() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    const QuantParams &getParams() const { return params; }
+};
+} // namespace infini
@@ -2,3 +2,16 @@
 #include "core/common.h"
 #include "utils/data_generator.h"
 #include "gtest/gtest.h"
+
+namespace infini {
+// Rounds float values to the bits of a 16-bit float type, which is how
+// expected outputs of half precision kernels are written.
+inline vector<uint16_t> roundToHalf(const vector<float> &values,
+                                    DataType dtype) {
+    vector<uint16_t> ret(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+        ret[i] = dtype == DataType::Float16 ? float_to_half(values[i])
+                                            : float_to_bfloat16(values[i]);
+    return ret;
+}
+} // namespace infini
@@ -0,0 +1,86 @@
+#pragma once
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include "core/tensor.h"
+
+namespace infini {
+
+/**
+ * @brief Precomputed walk over the output of a multidirectional broadcast.
+ *
+ * Inputs are right-aligned against the output shape and given one element
+ * stride per output dimension, 0 where they are broadcast. Output dimensions
+ * of extent 1 are dropped and adjacent dimensions that are laid out the same
+ * way in every input are merged, so that the output is covered by rows of
+ * `rowSize()` elements along which every input advances by 0 or 1 element.
+ * Inputs may also be strided views, given their element strides, in which
+ * case the step along a row may be larger.
+ * The walk itself only bumps offsets; no index is decomposed per element.
+ */
+class BroadcastIterator {
+  public:
+    BroadcastIterator(const Shape &output, const vector<Shape> &inputs);
+    BroadcastIterator(const Shape &output, const vector<Shape> &inputs,
+                      const vector<vector<size_t>> &inputStrides);
+
+    size_t numInputs() const { return strides.size(); }
+    // Number of output elements.
+    size_t size() const { return total; }
+    size_t rowSize() const { return dims.empty() ? 1 : dims.back(); }
+    size_t numRows() const { return total == 0 ? 0 : total / rowSize(); }
+    // Per-element step of input `i` along a row, 0 or 1 unless the input
+    // is a strided view.
+    size_t innerStride(size_t i) const {
+        return dims.empty() ? 0 : strides[i].back();
+    }
+    // True if every input has the output shape and layout, i.e. all inputs
+    // and the output can be walked as one flat contiguous row.
+    bool isContiguous() const { return contiguous; }
+
+    /**
+     * @brief Visits rows [rowBegin, rowEnd). `f(outOffset, inOffsets)` is
+     * called once per row with the element offset of the row in the output
+     * and in every input.
+     */
+    template <typename F>
+    void forEachRow(size_t rowBegin, size_t rowEnd, F &&f) const {
+        if (rowBegin >= rowEnd)
+            return;
+        size_t outerRank = dims.empty() ? 0 : dims.size() - 1;
+        size_t nIn = numInputs();
+        // Decompose the first row once, then advance incrementally.
+        vector<size_t> counter(outerRank, 0), offsets(nIn, 0);
+        for (size_t rest = rowBegin, d = outerRank; d-- > 0;) {
+            counter[d] = rest % dims[d];
+            rest /= dims[d];
+            for (size_t i = 0; i < nIn; ++i)
+                offsets[i] += counter[d] * strides[i][d];
+        }
+        size_t row = rowSize();
+        for (size_t r = rowBegin; r < rowEnd; ++r) {
+            f(r * row, offsets.data());
+            for (size_t d = outerRank; d-- > 0;) {
+                if (++counter[d] < (size_t)dims[d]) {
+                    for (size_t i = 0; i < nIn; ++i)
+                        offsets[i] += strides[i][d];
+                    break;
+                }
+                counter[d] = 0;
+                for (size_t i = 0; i < nIn; ++i)
+                    offsets[i] -= (dims[d] - 1) * strides[i][d];
+            }
+        }
+    }
+
+  private:
+    // Collapsed output shape and per-input strides over it.
+    Shape dims;
+    vector<vector<size_t>> strides;
+    size_t total;
+    bool contiguous;
+};
+
+} // namespace infini
+
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+#ifndef CPU_ISA_H
+#define CPU_ISA_H
+
+namespace infini {
+
+// x86 SIMD levels the CPU kernels are specialized for, in increasing order.
+enum class CpuIsa {
+    Scalar,
+    SSE41,
+    AVX2,
+    AVX512,
+};
+
+// Detect the best ISA of the running CPU once. The environment variable
+// INFINI_CPU_ISA (scalar, sse4.1, avx2, avx512) caps the detected level.
+CpuIsa detect_cpu_isa();
+const char *cpu_isa_name(CpuIsa isa);
+
+} // namespace infini
+
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 #include "core/common.h"
+#include "utils/half.h"
 #include <random>
 
 namespace infini {
@@ -16,7 +17,17 @@ public:
             fill(reinterpret_cast<uint32_t *>(data), size);
         else if (dataType == DataType::Float32)
             fill(reinterpret_cast<float *>(data), size);
-        else
+        else if (dataType == DataType::Float16 ||
+                 dataType == DataType::BFloat16) {
+            // Generated in float and rounded to the 16-bit format.
+            vector<float> values(size);
+            fill(values.data(), size);
+            auto out = reinterpret_cast<uint16_t *>(data);
+            for (size_t i = 0; i < size; ++i)
+                out[i] = dataType == DataType::Float16
+                             ? float_to_half(values[i])
+                             : float_to_bfloat16(values[i]);
+        } else
             IT_TODO_HALT();
     }
 };
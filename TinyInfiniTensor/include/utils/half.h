@@ -0,0 +1,79 @@
+#pragma once
+#ifndef HALF_H
+#define HALF_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace infini {
+
+// Scalar conversions between float and the 16-bit floating point formats,
+// which are stored as uint16_t. Narrowing rounds to nearest even, overflows
+// to infinity and quiets NaNs keeping the top of their payload, as the F16C
+// instructions and ONNX Cast do.
+
+inline uint32_t float_bits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+inline float bits_float(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// IEEE 754 binary16: 1 sign, 5 exponent and 10 mantissa bits.
+inline float half_to_float(uint16_t h) {
+    uint32_t sign = uint32_t(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1f, mant = h & 0x3ff;
+    if (exp == 0) {
+        // Zero or subnormal: mant * 2^-24, exact in float.
+        float value = float(mant) * bits_float(0x33800000);
+        return bits_float(float_bits(value) | sign);
+    }
+    if (exp == 0x1f) // Infinity, or a NaN which is quieted.
+        return bits_float(sign | 0x7f800000 | (mant << 13) |
+                          (mant ? 0x400000 : 0));
+    return bits_float(sign | ((exp + 112) << 23) | (mant << 13));
+}
+
+inline uint16_t float_to_half(float f) {
+    uint32_t bits = float_bits(f);
+    uint32_t sign = (bits >> 16) & 0x8000;
+    bits &= 0x7fffffff;
+    if (bits >= 0x47800000) // 65536 and above, infinities and NaNs.
+        return sign | (bits > 0x7f800000 ? 0x7e00 | ((bits >> 13) & 0x3ff)
+                                         : 0x7c00);
+    if (bits < 0x38800000) {
+        // Subnormal result: adding 0.5 aligns the mantissa so that the FPU
+        // rounds it to nearest even.
+        constexpr uint32_t magic = 0x3f000000;
+        return sign | uint16_t(float_bits(bits_float(bits) +
+                                          bits_float(magic)) -
+                               magic);
+    }
+    // Rebias the exponent and round the 13 dropped bits to nearest even; a
+    // carry correctly rounds up to the next binade or to infinity.
+    uint32_t odd = (bits >> 13) & 1;
+    bits += ((15u - 127u) << 23) + 0xfff + odd;
+    return sign | uint16_t(bits >> 13);
+}
+
+// bfloat16: the upper half of a float.
+inline float bfloat16_to_float(uint16_t b) {
+    return bits_float(uint32_t(b) << 16);
+}
+
+inline uint16_t float_to_bfloat16(float f) {
+    uint32_t bits = float_bits(f);
+    if ((bits & 0x7fffffff) > 0x7f800000)
+        return uint16_t((bits >> 16) | 0x40);
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return uint16_t(bits >> 16);
+}
+
+} // namespace infini
+
+#endif
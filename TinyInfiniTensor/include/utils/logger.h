@@ -0,0 +1,97 @@
+#pragma once
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+namespace infini {
+
+enum class LogLevel {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+    Off = 5,
+};
+
+// Messages below IT_LOG_COMPILE_LEVEL are compiled out entirely. The CMake
+// option INFINI_LOG_LEVEL sets it; by default Debug builds keep debug
+// messages and other builds start at info.
+#ifndef IT_LOG_COMPILE_LEVEL
+#ifdef DEBUG_MODE
+#define IT_LOG_COMPILE_LEVEL 1
+#else
+#define IT_LOG_COMPILE_LEVEL 2
+#endif
+#endif
+
+// The runtime level is read once from the environment variable
+// INFINI_LOG_LEVEL (trace, debug, info, warn, error, off), defaulting to
+// info, and can be changed with set_log_level.
+LogLevel get_log_level();
+void set_log_level(LogLevel level);
+const char *log_level_name(LogLevel level);
+
+inline bool log_enabled(LogLevel level) {
+    return int(level) >= IT_LOG_COMPILE_LEVEL && level >= get_log_level();
+}
+
+// Writes one line to stderr, without flushing it.
+void log_write(LogLevel level, const char *file, int line,
+               const std::string &msg);
+
+/**
+ * @brief Times a scope and logs `pass=<name> ms=<elapsed>` at debug level
+ * when it ends.
+ */
+class LogScopeTimer {
+  public:
+    LogScopeTimer(const char *name, const char *file, int line)
+        : name(name), file(file), line(line),
+          start(std::chrono::steady_clock::now()) {}
+    ~LogScopeTimer();
+
+  private:
+    const char *name, *file;
+    int line;
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace infini
+
+// `expr` is a stream expression, e.g. IT_LOG_DEBUG("size " << n). It is only
+// evaluated when the level is enabled.
+#define IT_LOG(level, expr)                                                    \
+    do {                                                                       \
+        if constexpr (int(level) >= IT_LOG_COMPILE_LEVEL) {                    \
+            if (::infini::log_enabled(level)) {                                \
+                std::ostringstream _it_log_oss;                                \
+                _it_log_oss << expr;                                           \
+                ::infini::log_write(level, __FILE__, __LINE__,                 \
+                                    _it_log_oss.str());                        \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+#define IT_LOG_TRACE(expr) IT_LOG(::infini::LogLevel::Trace, expr)
+#define IT_LOG_DEBUG(expr) IT_LOG(::infini::LogLevel::Debug, expr)
+#define IT_LOG_INFO(expr) IT_LOG(::infini::LogLevel::Info, expr)
+#define IT_LOG_WARN(expr) IT_LOG(::infini::LogLevel::Warn, expr)
+#define IT_LOG_ERROR(expr) IT_LOG(::infini::LogLevel::Error, expr)
+
+// Times the enclosing scope, see LogScopeTimer.
+#define _IT_LOG_CAT(A, B) A##B
+#define _IT_LOG_NAME(A, B) _IT_LOG_CAT(A, B)
+#if IT_LOG_COMPILE_LEVEL <= 1
+#define IT_LOG_SCOPE_TIMER(name)                                               \
+    ::infini::LogScopeTimer _IT_LOG_NAME(_it_log_timer_, __LINE__)(            \
+        name, __FILE__, __LINE__)
+#else
+#define IT_LOG_SCOPE_TIMER(name)                                               \
+    do {                                                                       \
+    } while (0)
+#endif
+
+#endif
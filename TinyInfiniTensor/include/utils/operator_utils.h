@@ -20,6 +20,8 @@ size_t delocate_index(const Shape &shapeIndex, const Shape &shape,
                       const Shape &stride);
 // Convert KernelAttrs to a string representation
 std::string get_kernel_attrs_str(const KernelAttrs &kernelAttrs);
+// Append the bits of an optional float to an operator attribute vector
+void append_float_attr(vector<int> &attrs, std::optional<float> value);
 
 } // namespace infini
 
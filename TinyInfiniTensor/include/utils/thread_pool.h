@@ -0,0 +1,108 @@
+#pragma once
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace infini {
+
+/**
+ * @brief Work-stealing pool shared by the graph executor and the kernels.
+ *
+ * Every worker owns a deque: it pushes and pops its own tasks at the back and
+ * idle workers steal from the front of the others. Threads outside the pool
+ * share one extra deque. A thread waiting for a TaskGroup keeps running
+ * queued tasks instead of blocking, so tasks may submit and wait for nested
+ * work (an operator splitting its loop) without deadlocking or spawning more
+ * threads than the pool has.
+ */
+class ThreadPool {
+  public:
+    // Tracks a set of submitted tasks. The first exception thrown by one of
+    // them is rethrown by `wait`.
+    class TaskGroup {
+        friend class ThreadPool;
+        std::atomic<size_t> pending{0};
+        std::mutex mutex;
+        std::exception_ptr error;
+    };
+
+    // `nThreads` counts the calling thread, so `nThreads - 1` workers are
+    // started. A pool of one thread runs everything inline in `wait`.
+    explicit ThreadPool(size_t nThreads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // The process-wide pool. Its size is read once from the environment
+    // variable INFINI_NUM_THREADS and defaults to the hardware concurrency.
+    static ThreadPool &getInstance();
+
+    size_t numThreads() const { return workers.size() + 1; }
+
+    void submit(TaskGroup &group, std::function<void()> task);
+    // Runs queued tasks until every task of `group` has finished.
+    void wait(TaskGroup &group);
+
+  private:
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup *group;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Queue of the calling thread: its own for a worker of this pool, the
+    // shared one (index 0) otherwise.
+    size_t localQueue() const;
+    bool tryPop(size_t self, Task &task);
+    void execute(Task &task);
+    void workerLoop(size_t self);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued{0};
+    std::mutex sleepMutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+};
+
+namespace detail {
+void parallel_for(size_t n, void (*fn)(const void *, size_t, size_t),
+                  const void *f);
+} // namespace detail
+
+/**
+ * @brief Splits [0, n) into contiguous chunks and calls `f(begin, end)` for
+ * each of them on the shared pool, returning when all are done. The caller
+ * runs chunks too. Per-chunk state such as scratch buffers can be set up at
+ * the top of `f`. A single chunk runs inline without touching the pool.
+ */
+template <typename F> void parallel_for(size_t n, const F &f) {
+    if (n <= 1) {
+        if (n == 1)
+            f(size_t(0), size_t(1));
+        return;
+    }
+    detail::parallel_for(
+        n,
+        [](const void *f, size_t begin, size_t end) {
+            (*static_cast<const F *>(f))(begin, end);
+        },
+        &f);
+}
+
+} // namespace infini
+
+#endif
@@ -1,4 +1,5 @@
 #include "core/allocator.h"
+#include <algorithm>
 #include <utility>
 
 namespace infini
@@ -7,12 +8,13 @@ namespace infini
     {
         used = 0;
         peak = 0;
+        capacity = 0;
         ptr = nullptr;
 
-        // 'alignment' defaults to sizeof(uint64_t), because it is the length of
-        // the longest data type currently supported by the DataType field of
-        // the tensor
-        alignment = sizeof(uint64_t);
+        // Offsets keep the alignment of the runtime's memory, which is at
+        // least sizeof(uint64_t), the length of the longest data type
+        // currently supported by the DataType field of the tensor
+        alignment = runtime->getAlignment();
     }
 
     Allocator::~Allocator()
@@ -24,32 +26,35 @@ namespace infini
     }
 
     size_t Allocator::alloc(size_t size)
-    {   
-        IT_ASSERT(this->ptr == nullptr);
+    {
         // pad the size to the multiple of alignment
         size = this->getAlignedSize(size);
         this -> used += size;
-        // Check if there are any free blocks that can be reused
-        for (auto it = free_blk.begin(); it != free_blk.end(); ++it)
+        // Best fit: the smallest free block that is large enough, lowest
+        // address first among blocks of the same size
+        auto fit = free_by_size.lower_bound({size, 0});
+        if (fit != free_by_size.end())
         {
-            if (it->second >= size)
+            size_t blockSize = fit->first, offset = fit->second;
+            eraseFreeBlock(offset, blockSize);
+            if (blockSize > size)
             {
-                // Found a free block that can be reused
-                size_t offset = it -> first;
-                if (it->second > size)
-                {
-                    // Split the free block if it's larger than needed
-                    free_blk[offset + size] = it -> second - size;
-                }
-                free_blk.erase(it);
-                // Do not need to update peak here
-                return offset;
+                // Split the free block if it's larger than needed
+                insertFreeBlock(offset + size, blockSize - size);
             }
-            // if it is the last one
-            if (it == --free_blk.end()) {
-                size_t offset = it -> first;
-                // simply extend the last one to the size you want and use it!
-                free_blk.erase(it);
+            // Do not need to update peak here
+            return offset;
+        }
+        // If the last free block ends at the top of the arena, simply extend
+        // it to the size we want and use it
+        if (!free_blk.empty())
+        {
+            auto last = std::prev(free_blk.end());
+            if (last->first + last->second == this->peak)
+            {
+                size_t offset = last->first;
+                eraseFreeBlock(offset, last->second);
+                this->peak = offset + size;
                 return offset;
             }
         }
@@ -60,34 +65,56 @@ namespace infini
 
     void Allocator::free(size_t addr, size_t size)
     {
-        IT_ASSERT(this->ptr == nullptr);
         size = getAlignedSize(size);
+        if (size == 0)
+            return;
         this->used -= size;
-        // Check if the free block can be merged with adjacent free blocks
-        for (auto it = free_blk.begin(); it != free_blk.end(); ++it) {
-            if (it -> first + it -> second == addr) {
-                free_blk[it -> first] += size;
-                return;
-            }
-            else if (addr + size == it -> first) {
-                free_blk[addr] = size + it -> second;
-                free_blk.erase(it);
-                return;
+        // Merge with the free blocks right after and right before this one
+        auto next = free_blk.lower_bound(addr);
+        if (next != free_blk.end() && addr + size == next->first)
+        {
+            size += next->second;
+            eraseFreeBlock(next->first, next->second);
+        }
+        auto prev = free_blk.lower_bound(addr);
+        if (prev != free_blk.begin())
+        {
+            --prev;
+            IT_ASSERT(prev->first + prev->second <= addr);
+            if (prev->first + prev->second == addr)
+            {
+                addr = prev->first;
+                size += prev->second;
+                eraseFreeBlock(prev->first, prev->second);
             }
         }
-        // Else we add a new free blk
-        free_blk[addr] = size;
-        // =================================== 作业 ===================================
-        // TODO: 设计一个算法来回收内存
-        // =================================== 作业 ===================================
+        insertFreeBlock(addr, size);
+    }
+
+    void Allocator::insertFreeBlock(size_t addr, size_t size)
+    {
+        free_blk.emplace(addr, size);
+        free_by_size.emplace(size, addr);
+    }
+
+    void Allocator::eraseFreeBlock(size_t addr, size_t size)
+    {
+        free_blk.erase(addr);
+        free_by_size.erase({size, addr});
     }
 
     void *Allocator::getPtr()
     {
-        if (this->ptr == nullptr)
+        // Grow the arena when allocations made since the last call need more
+        // memory. Contents are not preserved.
+        if (this->ptr == nullptr || this->capacity < this->peak)
         {
+            if (this->ptr != nullptr)
+                runtime->dealloc(this->ptr);
             this->ptr = runtime->alloc(this->peak);
-            printf("Allocator really alloc: %p %lu bytes\n", this->ptr, peak);
+            this->capacity = this->peak;
+            IT_LOG_DEBUG("Allocator really alloc: " << this->ptr << " "
+                                                     << this->peak << " bytes");
         }
         return this->ptr;
     }
@@ -100,7 +127,21 @@ namespace infini
 
     void Allocator::info()
     {
-        std::cout << "Used memory: " << this->used
-                  << ", peak memory: " << this->peak << std::endl;
+        size_t freeBytes = 0, largest = 0;
+        for (const auto &[addr, size] : free_blk)
+        {
+            freeBytes += size;
+            largest = std::max(largest, size);
+        }
+        // Share of the free memory that cannot serve one request of the
+        // size of the largest free block
+        double fragmentation =
+            freeBytes == 0 ? 0.0 : 1.0 - double(largest) / double(freeBytes);
+        IT_LOG_INFO("Used memory: " << this->used
+                                    << ", peak memory: " << this->peak
+                                    << ", free blocks: " << free_blk.size()
+                                    << ", free memory: " << freeBytes
+                                    << ", largest free block: " << largest
+                                    << ", fragmentation: " << fragmentation);
     }
 }
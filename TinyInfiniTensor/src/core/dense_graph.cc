@@ -0,0 +1,93 @@
+#include "core/dense_graph.h"
+#include <algorithm>
+
+namespace infini
+{
+
+    DenseGraph::DenseGraph(const OpVec &ops, const TensorVec &tensors)
+    {
+        IT_ASSERT(ops.size() < None && tensors.size() < None);
+        size_t nOps = ops.size(), nTensors = tensors.size();
+        this->ops.reserve(nOps);
+        this->tensors.reserve(nTensors);
+        opIds.reserve(nOps);
+        tensorIds.reserve(nTensors);
+        for (size_t i = 0; i < nTensors; ++i)
+        {
+            this->tensors.push_back({tensors[i].get(), None, tensors[i]->getBytes()});
+            tensorIds.emplace(tensors[i].get(), Id(i));
+        }
+        for (size_t i = 0; i < nOps; ++i)
+        {
+            this->ops.emplace_back(ops[i].get());
+            opIds.emplace(ops[i].get(), Id(i));
+        }
+
+        // Operator -> tensor edges, and the producer of every tensor
+        for (size_t i = 0; i < nOps; ++i)
+        {
+            for (auto &input : ops[i]->getInputs())
+                if (Id t = input ? tensorId(input.get()) : None; t != None)
+                    opInputs.ids.emplace_back(t);
+            opInputs.offsets.emplace_back(opInputs.ids.size());
+            for (auto &output : ops[i]->getOutputs())
+                if (Id t = output ? tensorId(output.get()) : None; t != None)
+                {
+                    opOutputs.ids.emplace_back(t);
+                    this->tensors[t].source = Id(i);
+                }
+            opOutputs.offsets.emplace_back(opOutputs.ids.size());
+        }
+
+        // Tensor -> consumer edges by counting sort, so that every row is in
+        // operator order
+        vector<Id> &offsets = tensorTargets.offsets;
+        offsets.assign(nTensors + 1, 0);
+        for (auto t : opInputs.ids)
+            ++offsets[t + 1];
+        for (size_t t = 0; t < nTensors; ++t)
+            offsets[t + 1] += offsets[t];
+        tensorTargets.ids.resize(opInputs.ids.size());
+        vector<Id> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < nOps; ++i)
+            for (auto t : inputs(Id(i)))
+                tensorTargets.ids[fill[t]++] = Id(i);
+
+        // Operator -> operator edges, deduplicated
+        vector<Id> row;
+        for (size_t i = 0; i < nOps; ++i)
+        {
+            row.clear();
+            for (auto t : inputs(Id(i)))
+                if (Id src = source(t); src != None)
+                    row.emplace_back(src);
+            std::sort(row.begin(), row.end());
+            row.erase(std::unique(row.begin(), row.end()), row.end());
+            opPredecessors.ids.insert(opPredecessors.ids.end(), row.begin(),
+                                      row.end());
+            opPredecessors.offsets.emplace_back(opPredecessors.ids.size());
+
+            row.clear();
+            for (auto t : outputs(Id(i)))
+                row.insert(row.end(), targets(t).begin(), targets(t).end());
+            std::sort(row.begin(), row.end());
+            row.erase(std::unique(row.begin(), row.end()), row.end());
+            opSuccessors.ids.insert(opSuccessors.ids.end(), row.begin(),
+                                    row.end());
+            opSuccessors.offsets.emplace_back(opSuccessors.ids.size());
+        }
+    }
+
+    DenseGraph::Id DenseGraph::opId(const OperatorObj *op) const
+    {
+        auto it = opIds.find(op);
+        return it == opIds.end() ? None : it->second;
+    }
+
+    DenseGraph::Id DenseGraph::tensorId(const TensorObj *tensor) const
+    {
+        auto it = tensorIds.find(tensor);
+        return it == tensorIds.end() ? None : it->second;
+    }
+
+} // namespace infini
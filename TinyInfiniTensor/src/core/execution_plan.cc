@@ -0,0 +1,192 @@
+#include "core/execution_plan.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+
+namespace infini
+{
+    namespace
+    {
+        using Id = DenseGraph::Id;
+
+        /**
+         * @brief Successors of every operator for concurrent execution: the
+         * data edges of the graph, plus an edge from the last users of every
+         * tensor to the producer of each later tensor placed over its memory.
+         *
+         * The memory plan reuses buffers across tensors whose lifetimes are
+         * disjoint in the operator steps it was planned with. Once
+         * independent branches run concurrently that order no longer holds by
+         * itself, so an operator may only overwrite a buffer after its
+         * previous occupant is dead. Memory is tracked as a map of disjoint
+         * byte ranges to their latest occupant, so only the direct previous
+         * occupants need an edge; older ones are ordered transitively.
+         *
+         * A tensor and the views into its memory share one buffer. They are
+         * tracked as one occupant whose users are the users of all of them.
+         */
+        vector<vector<Id>> scheduleSuccessors(const DenseGraph &g)
+        {
+            size_t nOps = g.numOps(), nTensors = g.numTensors();
+            vector<vector<Id>> successors(nOps);
+            for (Id op = 0; op < nOps; ++op)
+                successors[op].assign(g.successors(op).begin(),
+                                      g.successors(op).end());
+
+            // Owner of the memory of every tensor, and the operators that
+            // must be done before that memory may be reused.
+            vector<Id> owner(nTensors);
+            vector<vector<Id>> users(nTensors);
+            for (Id tensor = 0; tensor < nTensors; ++tensor)
+            {
+                auto base = g.getTensor(tensor)->getViewBase();
+                owner[tensor] = base ? g.tensorId(base.get()) : tensor;
+                IT_ASSERT(owner[tensor] != DenseGraph::None);
+            }
+            for (Id tensor = 0; tensor < nTensors; ++tensor)
+            {
+                auto &list = users[owner[tensor]];
+                auto targets = g.targets(tensor);
+                if (targets.empty() && g.source(tensor) != DenseGraph::None)
+                    list.emplace_back(g.source(tensor));
+                list.insert(list.end(), targets.begin(), targets.end());
+            }
+
+            // Byte range start -> (end, owner occupying it).
+            std::map<uintptr_t, std::pair<uintptr_t, Id>> occupied;
+            vector<Id> previous;
+            auto place = [&](Id tensor)
+            {
+                previous.clear();
+                size_t bytes = g.bytes(tensor);
+                if (bytes == 0)
+                    return;
+                auto begin = reinterpret_cast<uintptr_t>(
+                    g.getTensor(tensor)->getRawDataPtr<void *>());
+                auto end = begin + bytes;
+                auto it = occupied.upper_bound(begin);
+                if (it != occupied.begin() &&
+                    std::prev(it)->second.first > begin)
+                    --it;
+                while (it != occupied.end() && it->first < end)
+                {
+                    auto [first, range] = *it;
+                    it = occupied.erase(it);
+                    if (range.second != owner[tensor])
+                        previous.emplace_back(range.second);
+                    if (first < begin)
+                        occupied.emplace(first,
+                                         std::make_pair(begin, range.second));
+                    if (range.first > end)
+                        it = occupied.emplace(end, range).first;
+                }
+                occupied.emplace(begin, std::make_pair(end, owner[tensor]));
+            };
+
+            for (Id tensor = 0; tensor < nTensors; ++tensor)
+                if (g.source(tensor) == DenseGraph::None)
+                    place(tensor);
+            // The memory plan releases buffers in operator id order, so the
+            // users of a previous occupant all come before `op` and every
+            // edge points forward.
+            for (Id op = 0; op < nOps; ++op)
+                for (auto output : g.outputs(op))
+                {
+                    place(output);
+                    for (auto tensor : previous)
+                        for (auto user : users[tensor])
+                        {
+                            IT_ASSERT(user < op, "Memory of a tensor is "
+                                                 "reused before its last use");
+                            successors[user].emplace_back(op);
+                        }
+                }
+
+            for (auto &next : successors)
+            {
+                std::sort(next.begin(), next.end());
+                next.erase(std::unique(next.begin(), next.end()), next.end());
+            }
+            return successors;
+        }
+    } // namespace
+
+    ExecutionPlan::ExecutionPlan(const OpVec &ops, const DenseGraph &g,
+                                 const RuntimeObj *runtime)
+    {
+        const auto &kernelRegistry = KernelRegistry::getInstance();
+        steps.reserve(ops.size());
+        for (auto &op : ops)
+        {
+            auto kernelAttrs =
+                KernelAttrs{runtime->getDevice(), op->getOpType().underlying()};
+            steps.emplace_back(
+                kernelRegistry.getKernel(kernelAttrs)->prepare(op, runtime));
+        }
+
+        auto successors = scheduleSuccessors(g);
+        nPredecessors.assign(ops.size(), 0);
+        successorOffsets.emplace_back(0);
+        // Operator ids are topologically sorted; edges that all point
+        // forward make the schedule acyclic, so that every step runs.
+        for (Id op = 0; op < ops.size(); ++op)
+            for (auto next : successors[op])
+                IT_ASSERT(next > op, "Cycle in the execution schedule");
+        for (auto &next : successors)
+        {
+            for (auto op : next)
+                ++nPredecessors[op];
+            successorIds.insert(successorIds.end(), next.begin(), next.end());
+            successorOffsets.emplace_back(successorIds.size());
+        }
+        for (Id op = 0; op < ops.size(); ++op)
+            if (nPredecessors[op] == 0)
+                roots.emplace_back(op);
+    }
+
+    void ExecutionPlan::run() const
+    {
+        auto &pool = ThreadPool::getInstance();
+        if (pool.numThreads() == 1 || steps.size() <= 1)
+        {
+            for (auto &step : steps)
+                step();
+            return;
+        }
+
+        // Wavefront execution. Kernels split their own loops over the same
+        // pool, so branch and loop parallelism share its threads.
+        auto remaining = std::make_unique<std::atomic<Id>[]>(steps.size());
+        for (size_t op = 0; op < steps.size(); ++op)
+            remaining[op].store(nPredecessors[op], std::memory_order_relaxed);
+
+        ThreadPool::TaskGroup group;
+        std::atomic<size_t> nDone{0};
+        std::function<void(Id)> launch = [&](Id op)
+        {
+            pool.submit(group, [&, op]
+                        {
+                            steps[op]();
+                            nDone.fetch_add(1, std::memory_order_relaxed);
+                            for (Id i = successorOffsets[op];
+                                 i < successorOffsets[op + 1]; ++i)
+                            {
+                                Id next = successorIds[i];
+                                if (remaining[next].fetch_sub(
+                                        1, std::memory_order_acq_rel) == 1)
+                                    launch(next);
+                            }
+                        });
+        };
+        for (auto op : roots)
+            launch(op);
+        // Steps downstream of a failed kernel are never launched; the first
+        // error is rethrown here.
+        pool.wait(group);
+        IT_ASSERT(nDone.load() == steps.size(),
+                  "Steps of the execution plan were never launched");
+    }
+
+} // namespace infini
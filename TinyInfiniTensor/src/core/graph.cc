@@ -1,9 +1,13 @@
 #include "core/graph.h"
-#include "operators/matmul.h"
-#include "operators/transpose.h"
+#include "core/kernel.h"
+#include "core/memory_planner.h"
+#include "core/rewrite_rule.h"
+#include "core/view_planner.h"
 #include <algorithm>
+#include <deque>
 #include <numeric>
 #include <queue>
+#include <unordered_set>
 
 namespace infini
 {
@@ -11,6 +15,8 @@ namespace infini
     void GraphObj::addOperatorAndConnect(const Operator &op)
     {
         sorted = false;
+        invalidateViews();
+        opIndex.try_emplace(op->getGuid(), ops.size());
         ops.push_back(op);
         for (auto &input : op->getInputs())
         {
@@ -46,13 +52,15 @@ namespace infini
             oss << tensor << "\n";
 
         oss << "Graph operators:\n";
-        for (const auto &op : ops)
+        const auto &g = getDenseGraph();
+        for (size_t i = 0; i < ops.size(); ++i)
         {
+            const auto &op = ops[i];
             vector<UidBaseType> preds, succs;
-            for (auto &o : op->getPredecessors())
-                preds.emplace_back(o->getGuid());
-            for (auto &o : op->getSuccessors())
-                succs.emplace_back(o->getGuid());
+            for (auto o : g.predecessors(i))
+                preds.emplace_back(ops[o]->getGuid());
+            for (auto o : g.successors(i))
+                succs.emplace_back(ops[o]->getGuid());
             oss << "OP " << op->getGuid();
             oss << ", pred " << vecToString(preds);
             oss << ", succ " << vecToString(succs);
@@ -61,287 +69,463 @@ namespace infini
         return oss.str();
     }
 
-    bool GraphObj::topo_sort()
+    bool GraphObj::topo_sort(TopoOrder order)
     {
-        if (this->sorted)
+        IT_LOG_SCOPE_TIMER("topo_sort");
+        if (this->sorted && order == TopoOrder::Stable)
         {
             return true;
         }
-        std::vector<Operator> sorted;
-        // hash table
-        std::unordered_set<OperatorObj *> flags;
-        sorted.reserve(ops.size());
-        flags.reserve(ops.size());
-        while (sorted.size() < ops.size())
+        // Kahn's algorithm over the producer -> consumer edges
+        const auto &g = getDenseGraph();
+        size_t n = g.numOps();
+        vector<size_t> inDegree(n);
+        for (size_t i = 0; i < n; ++i)
+            inDegree[i] = g.predecessors(i).size();
+
+        // Remaining uses of every intermediate tensor, to tell how many bytes
+        // an operator releases when it runs
+        vector<size_t> remainingUses;
+        if (order == TopoOrder::MemoryAware)
         {
-            // Any node is move to sorted in this loop.
-            auto modified = false;
-            for (auto const &op : ops)
+            remainingUses.resize(g.numTensors());
+            for (size_t t = 0; t < g.numTensors(); ++t)
+                remainingUses[t] = g.targets(t).size();
+        }
+        auto releasedBytes = [&](size_t i)
+        {
+            int64_t bytes = 0;
+            for (auto t : g.outputs(i))
+                bytes -= g.bytes(t);
+            auto inputs = g.inputs(i);
+            for (size_t j = 0; j < inputs.size(); ++j)
+            {
+                auto t = inputs[j];
+                if (g.source(t) == DenseGraph::None ||
+                    std::find(inputs.begin(), inputs.begin() + j, t) !=
+                        inputs.begin() + j)
+                    continue;
+                if (remainingUses[t] ==
+                    size_t(std::count(inputs.begin(), inputs.end(), t)))
+                    bytes += g.bytes(t);
+            }
+            return bytes;
+        };
+
+        // Ready operators are taken by lowest original position, so the order
+        // is deterministic and keeps the insertion order whenever it is valid
+        vector<size_t> ready;
+        auto later = std::greater<size_t>();
+        for (size_t i = 0; i < n; ++i)
+            if (inDegree[i] == 0)
+                ready.emplace_back(i);
+        std::make_heap(ready.begin(), ready.end(), later);
+
+        OpVec result;
+        result.reserve(n);
+        while (!ready.empty())
+        {
+            size_t next;
+            if (order == TopoOrder::MemoryAware)
             {
-                if (auto const &inputs = op->getInputs();
-                    flags.find(op.get()) == flags.end() &&
-                    std::all_of(inputs.begin(), inputs.end(),
-                                [&flags](auto const &input)
-                                {
-                                    auto ptr = input->getSource().get();
-                                    return !ptr || flags.find(ptr) != flags.end();
-                                }))
+                // Ready sets are small; rescoring them keeps the scores exact
+                auto best = ready.begin();
+                int64_t bestBytes = releasedBytes(*best);
+                for (auto it = std::next(ready.begin()); it != ready.end(); ++it)
                 {
-                    modified = true;
-                    sorted.emplace_back(op);
-                    flags.insert(op.get());
+                    int64_t bytes = releasedBytes(*it);
+                    if (bytes > bestBytes || (bytes == bestBytes && *it < *best))
+                    {
+                        best = it;
+                        bestBytes = bytes;
+                    }
                 }
+                next = *best;
+                *best = ready.back();
+                ready.pop_back();
+                for (auto t : g.inputs(next))
+                    --remainingUses[t];
             }
-            if (!modified)
+            else
             {
-                return false;
+                std::pop_heap(ready.begin(), ready.end(), later);
+                next = ready.back();
+                ready.pop_back();
             }
+            result.emplace_back(ops[next]);
+            for (auto consumer : g.successors(next))
+            {
+                if (--inDegree[consumer] == 0)
+                {
+                    ready.emplace_back(consumer);
+                    if (order == TopoOrder::Stable)
+                        std::push_heap(ready.begin(), ready.end(), later);
+                }
+            }
+        }
+        if (result.size() < n)
+        {
+            return false;
         }
-        this->ops = std::move(sorted);
+        this->ops = std::move(result);
+        invalidateViews();
+        reindexOperators();
         return this->sorted = true;
     }
 
-    // void GraphObj::optimize()
-    // {
-    //     // =================================== 作业 ===================================
-    //     // TODO: 设计一个算法来实现指定的图优化规则
-    //     // 图优化规则如下：
-    //     // 1. 去除冗余的算子（例如，两个相邻的算子都是 transpose 算子，且做的是相反的操作，可以将其全部删除）如何判断相邻？前驱后继关系 如何删除？removeOp/removeTensor
-    //     // 2. 合并算子（例如，矩阵乘算子中含有属性transA、transB，如果其输入存在transpose，且对最后两个维度做交换，就可以将transpose融入到矩阵乘算子的属性中去）
-    //     // =================================== 作业 ===================================
-    //     // 拓扑排序
-    //     IT_ASSERT(topo_sort() == true);
-    //     std::cout << "before optimize" << std::endl;
-    //     // store the ops need to be removed
-    //     std::unordered_set<Operator> removeOps;
-    //     std::unordered_set<Tensor> removeTensors;
-        
-    //     // ops has been sorted
-    //     for (auto &op: ops) {
-    //         std::cout << "op: " << std::endl;
-    //         std::cout << op -> toString() << std::endl;
-    //         auto prevOps = op -> getPredecessors();
-    //         std::cout << "prevOps: " << std::endl;
-    //         for (auto prevOp: prevOps) { std::cout << prevOp -> toString() << std::endl; }
-
-
-    //         // consider 2 transpose ops
-    //         if (prevOps.size() != 0 &&
-    //             op-> getOpType() == infini::OpType::Transpose &&
-    //             prevOps[0] -> getOpType() == infini::OpType::Transpose) 
-    //         {
-    //             std::cout << "merge 2 transposes" << std::endl;
-    //             auto s1 = dynamic_cast<TransposeObj*>(prevOps[0].get()) -> getPermute(), s2 = dynamic_cast<TransposeObj*>(op.get()) -> getPermute();
-    //             Tensor tensor0 = prevOps[0] -> getInputs()[0], tensor1 = op -> getInputs()[0], tensor2 = op -> getOutput();
-    //             Operator op1 = tensor0 -> getSource();
-
-
-    //             // if s1 == s2, remove transpose ops
-    //             if (s1 == s2) {
-    //                 // renew tensor0 attributes
-    //                 std::cout << "renew tensor0 attributes" << std::endl;
-    //                 tensor0 -> removeTarget(prevOps[0]);
-    //                 for (auto &target: tensor2 -> getTargets()) {
-    //                     tensor0 -> addTarget(target);
-    //                 }
-
-
-    //                 // renew op2 attributes
-    //                 std::cout << "renew op2 attributes" << std::endl;
-    //                 for (auto op2: tensor2 -> getTargets()) {
-    //                     op2 -> removePredecessors(op);
-    //                     op2 -> addPredecessors(op1);
-    //                 }
-
-
-    //                 // renew op1 attributes
-    //                 std::cout << "renew op1 attributes" << std::endl;
-    //                 for (auto &op: ops) { std::cout << op -> toString() << std::endl; }
-    //                 for (auto &target: tensor0 -> getTargets()) {
-    //                     target -> replaceInput(tensor2, tensor0);
-    //                     target -> removePredecessors(op);
-    //                     target -> addPredecessors(prevOps[0]);
-    //                 }
-
-
-    //                 // remove useless tensors
-    //                 std::cout << "remove useless tensors" << std::endl;
-    //                 removeTensors.insert(tensor1);
-    //                 removeTensors.insert(tensor2);
-
-
-    //                 // remove useless ops
-    //                 std::cout << "remove useless ops" << std::endl;
-    //                 removeOps.insert(op);
-    //                 removeOps.insert(prevOps[0]);
-
-    //             } 
-    //             // if s1 != s2, merge transpose ops
-    //             // else { 
-                    
-    //             // }
-                
-    //         }
-    //         // merge transpose and matmul 
-    //         // else if(op -> getOpType() == infini::OpType::MatMul) {
-    //         //     auto &inputs = op -> getInputs();
-    //         //     for (auto prevOp: prevOps) {
-    //         //         if (prevOp -> getOpType() == infini::OpType::Transpose) {
-    //         //             auto it = std::find(inputs.begin(), inputs.end(), prevOp -> getOutput());
-    //         //             if (it - inputs.begin() == 0) { }
-    //         //         }
-    //         //     }
-    //         // }
-    //     }
-    //     std::cout << "after optimize" << std::endl;
-    //     // for (auto &op: removeOps) { removeOperator(op); }
-    //     // for (auto &tensor: removeTensors) { removeTensor(tensor); }
-    // }
-
-    void GraphObj::optimize() {
-  using namespace infini;
-
-  // Keep looping until no more optimization can be done
-  bool optimized = true;
-  while (optimized) {
-    optimized = false;
-    for (auto it = ops.begin(); it != ops.end(); ++it) {
-      const auto op = *it;
-
-      if (op->type == OpType::Transpose) {
-        // 1. Two consecutive transpose operators should be simplified
-        auto next = std::next(it);
-        if (next != ops.end() && next->get()->type == OpType::Transpose) {
-          auto next_op = *next;
-          auto perm1 = as<TransposeObj>(op)->getPermute();
-          auto perm2 = as<TransposeObj>(next_op)->getPermute();
-          auto perm = perm1;
-          for (size_t i = 0; i < perm.size(); ++i) {
-            perm[i] = perm2[perm1[i]];
-          }
-          auto naive = std::all_of(perm.begin(), perm.end(),
-                                   [i = 0](int p) mutable { return p == i++; });
-
-          if (naive) {
-            // Delete both
-            op->getInputs(0)->removeTarget(op);
-            for (auto succ : next_op->getSuccessors()) {
-              op->getInputs(0)->addTarget(succ);
-              succ->removePredecessors(next_op);
-              succ->replaceInput(next_op->getOutput(), op->getInputs(0));
-            }
-
-            for (auto pred : op->getPredecessors()) {
-              next_op->getOutputs()[0]->setSource(op);
-              pred->removeSuccessors(op);
+    void GraphObj::optimize()
+    {
+        IT_LOG_SCOPE_TIMER("optimize");
+        eliminateCommonSubexpressions();
+        eliminateDeadCode();
+        const auto &registry = RewriteRuleRegistry::getInstance();
+        // Removed ops and tensors are left as tombstones until the end
+        deferCompaction = true;
+
+        std::deque<Operator> worklist(ops.begin(), ops.end());
+        std::unordered_set<OperatorObj *> queued;
+        for (auto &op : ops)
+            queued.insert(op.get());
+        OpVec affected;
+        auto enqueueAffected = [&]
+        {
+            for (auto &next : affected)
+                if (hasOperator(next) && queued.insert(next.get()).second)
+                    worklist.emplace_back(next);
+        };
+        size_t nRewrites = 0, nFolded = 0;
+        while (!worklist.empty())
+        {
+            auto op = std::move(worklist.front());
+            worklist.pop_front();
+            queued.erase(op.get());
+            if (!hasOperator(op))
+                continue;
+            affected.clear();
+            if (foldConstant(op, affected))
+            {
+                ++nFolded;
+                IT_LOG_TRACE("fold constant op " << op->getGuid());
+                enqueueAffected();
+                continue;
             }
-
-            if (next_op->getSuccessors().size() != 0 &&
-                op->getPredecessors().size() != 0) {
-              for (auto succ : next_op->getSuccessors()) {
-                for (auto pred : op->getPredecessors()) {
-                  pred->addSuccessors(succ);
-                  succ->addPredecessors(pred);
-                }
-              }
+            for (const auto &[name, rule] : registry.getRules(op->getOpType()))
+            {
+                affected.clear();
+                if (!rule(*this, op, affected))
+                    continue;
+                ++nRewrites;
+                IT_LOG_TRACE("rewrite " << name << " on op " << op->getGuid());
+                enqueueAffected();
+                break;
             }
+        }
 
-            removeTensor(next_op->getOutput());
-            removeTensor(op->getOutput());
-            removeOperator(next_op);
-            removeOperator(op);
-          } else {
-            auto newOp = addOpWithOutputs<TransposeObj>(
-                op->getInputs(0), next_op->getOutput(), perm);
-
-            op->getInputs(0)->removeTarget(op);
-            for (auto pred : op->getPredecessors()) {
-              pred->removeSuccessors(op);
-            }
+        deferCompaction = false;
+        compact();
+        // Rewrites may leave equal operators behind, e.g. the same
+        // dequantization moved below two consumers.
+        if (nRewrites + nFolded > 0)
+        {
+            eliminateCommonSubexpressions();
+            eliminateDeadCode();
+        }
+        IT_LOG_DEBUG("optimize: " << nRewrites << " rewrites, " << nFolded
+                                  << " constants folded, " << ops.size()
+                                  << " ops left");
+    }
 
-            for (auto succ : next_op->getSuccessors()) {
-              succ->removePredecessors(next_op);
+    void GraphObj::eliminateCommonSubexpressions()
+    {
+        IT_LOG_SCOPE_TIMER("eliminateCommonSubexpressions");
+        // In topological order the inputs of an operator are already merged
+        // when it is visited.
+        IT_ASSERT(topo_sort() == true);
+        auto isOutput = [&](const Tensor &t)
+        {
+            return designatedOutputs.empty() ? t->getTargets().empty()
+                                             : isDesignatedOutput(t);
+        };
+        auto producesOutput = [&](const Operator &op)
+        {
+            const auto &outputs = op->getOutputs();
+            return std::any_of(outputs.begin(), outputs.end(), isOutput);
+        };
+
+        deferCompaction = true;
+        std::unordered_map<size_t, OpVec> seen;
+        size_t nMerged = 0;
+        for (auto op : OpVec(ops))
+        {
+            auto &candidates = seen[op->hash()];
+            auto attrs = op->getOpAttrVector();
+            auto same = std::find_if(
+                candidates.begin(), candidates.end(),
+                [&](const Operator &other)
+                {
+                    return other->getInputs() == op->getInputs() &&
+                           other->getOpAttrVector() == attrs;
+                });
+            // Without designated outputs, a merged operator would also stop
+            // producing a graph output by gaining consumers.
+            if (same == candidates.end() || producesOutput(op) ||
+                (designatedOutputs.empty() && producesOutput(*same)))
+            {
+                candidates.emplace_back(op);
+                continue;
             }
-            removeTensor(op->getOutput());
-            removeOperator(op);
-            removeOperator(next_op);
-          }
+            for (size_t i = 0; i < op->getOutputs().size(); ++i)
+                replaceAllUses(op->getOutput(i), (*same)->getOutput(i));
+            disconnectOperator(op);
+            for (auto &output : op->getOutputs())
+                removeTensor(output);
+            ++nMerged;
+        }
+        deferCompaction = false;
+        compact();
+        IT_LOG_DEBUG("eliminateCommonSubexpressions: " << nMerged
+                                                       << " ops merged");
+    }
 
-          optimized = true;
-          break;
+    void GraphObj::eliminateDeadCode()
+    {
+        if (designatedOutputs.empty())
+            return;
+        IT_LOG_SCOPE_TIMER("eliminateDeadCode");
+        std::unordered_set<OperatorObj *> live;
+        OpVec stack;
+        for (auto &output : designatedOutputs)
+            if (auto source = output->getSource())
+                stack.emplace_back(source);
+        while (!stack.empty())
+        {
+            auto op = std::move(stack.back());
+            stack.pop_back();
+            if (!live.insert(op.get()).second)
+                continue;
+            for (auto &input : op->getInputs())
+                if (auto source = input->getSource())
+                    stack.emplace_back(source);
         }
-      }
-
-      if (op->type == OpType::MatMul) {
-        // 2. Merge transpose operators into matmul operators
-        const auto &matmul_op = as<MatmulObj>(op);
-        const auto &inputs = matmul_op->getInputs();
-        // check if inputs have a transpose operator for last two
-        // dimensions
-        for (const auto &input : inputs) {
-          if (input->getSource() == nullptr ||
-              input->getSource()->type != OpType::Transpose)
-            continue;
-          const auto &transpose_op = as<TransposeObj>(input->getSource());
-
-          // Other dimensions should not be transposed
-          auto perm = transpose_op->getPermute();
-          if (!std::all_of(perm.begin(), perm.begin() + perm.size() - 2,
-                           [i = 0](int p) mutable { return p == i++; }))
-            continue;
-
-          // Last two dimensions should be transposed
-          if (perm[perm.size() - 1] - perm[perm.size() - 2] == 1)
-            continue;
-
-          // Merge transpose into matmul
-          if (input == inputs[0]) {
-            matmul_op->setTransA(!matmul_op->getTransA());
-          } else {
-            matmul_op->setTransB(!matmul_op->getTransB());
-          }
-
-          // Connect the matmul with the input of the transpose operator
-          matmul_op->replaceInput(input, transpose_op->getInputs(0));
-          transpose_op->getInputs(0)->removeTarget(transpose_op);
-          transpose_op->getInputs(0)->addTarget(matmul_op);
-
-          // Op connections
-          matmul_op->removePredecessors(transpose_op);
-          for (auto pred : transpose_op->getPredecessors()) {
-            matmul_op->addPredecessors(pred);
-            pred->addSuccessors(matmul_op);
-            pred->removeSuccessors(transpose_op);
-          }
-
-          // Delete the transpose operator
-          removeTensor(transpose_op->getOutputs()[0]);
-          removeOperator(transpose_op);
-
-          optimized = true;
+
+        deferCompaction = true;
+        size_t nOps = ops.size();
+        for (auto op : OpVec(ops))
+            if (!live.count(op.get()))
+                disconnectOperator(op);
+        for (auto tensor : TensorVec(tensors))
+            if (tensor->getTargets().empty() && !tensor->getSource() &&
+                !isDesignatedOutput(tensor))
+                removeTensor(tensor);
+        deferCompaction = false;
+        compact();
+        IT_LOG_DEBUG("eliminateDeadCode: " << nOps - ops.size()
+                                           << " ops removed");
+    }
+
+    void GraphObj::setOutputs(const TensorVec &outputs)
+    {
+        designatedOutputs.clear();
+        designatedOutputFuids.clear();
+        for (auto &output : outputs)
+        {
+            IT_ASSERT(hasTensor(output));
+            if (designatedOutputFuids.insert(output->getFuid()).second)
+                designatedOutputs.emplace_back(output);
         }
+        invalidateViews();
+    }
 
-        if (optimized)
-          break;
-      }
-      // Finish the optimization
+    bool GraphObj::foldConstant(const Operator &op, OpVec &affected)
+    {
+        // Dequantized weights would take four times the memory, and
+        // rewrites move the dequantization past integer operators instead.
+        if (op->getOpType() == OpType::DequantizeLinear)
+            return false;
+        const auto &inputs = op->getInputs();
+        if (inputs.empty() ||
+            !std::all_of(inputs.begin(), inputs.end(),
+                         [](const Tensor &t) { return t->isConstant(); }))
+            return false;
+        for (auto &output : op->getOutputs())
+            if (output->getTargets().empty() || isDesignatedOutput(output))
+                return false;
+        KernelAttrs kernelAttrs{runtime->getDevice(),
+                                op->getOpType().underlying()};
+        const auto &kernelRegistry = KernelRegistry::getInstance();
+        if (!kernelRegistry.hasKernel(kernelAttrs))
+            return false;
+
+        // Inputs already point at their constant memory; the kernel writes
+        // straight into that of the outputs.
+        for (auto &output : op->getOutputs())
+            output->setConstant([](void *, size_t, DataType) {});
+        kernelRegistry.getKernel(kernelAttrs)->compute(op, runtime.get());
+
+        disconnectOperator(op);
+        for (auto &input : inputs)
+            if (hasTensor(input) && input->getTargets().empty() &&
+                !isDesignatedOutput(input))
+                removeTensor(input);
+        for (auto &output : op->getOutputs())
+            for (auto &consumer : output->getTargets())
+                affected.emplace_back(consumer);
+        return true;
     }
-  }
-}
-    Tensor GraphObj::getTensor(int fuid) const
+
+    void GraphObj::reconnectInputs(const Operator &op, const TensorVec &oldInputs)
     {
-        for (auto tensor : tensors)
+        for (auto &input : oldInputs)
         {
-            if (tensor->getFuid() == fuid)
+            if (!input)
+                continue;
+            input->removeTarget(op);
+            if (auto pred = input->getSource())
+                pred->removeSuccessors(op);
+        }
+        op->predecessors.clear();
+        for (auto &input : op->getInputs())
+        {
+            if (!input)
+                continue;
+            input->addTarget(op);
+            if (auto pred = input->getSource())
             {
-                return tensor;
+                pred->addSuccessors(op);
+                op->addPredecessors(pred);
             }
         }
-        return nullptr;
+        invalidateViews();
+    }
+
+    void GraphObj::replaceInput(const Operator &op, size_t index,
+                                const Tensor &tensor)
+    {
+        IT_ASSERT(index < op->inputs.size());
+        auto oldInputs = op->inputs;
+        op->inputs[index] = tensor;
+        reconnectInputs(op, oldInputs);
+    }
+
+    void GraphObj::replaceAllUses(const Tensor &from, const Tensor &to)
+    {
+        for (auto &op : from->getTargets())
+        {
+            if (!hasOperator(op))
+                continue;
+            auto oldInputs = op->inputs;
+            std::replace(op->inputs.begin(), op->inputs.end(), from, to);
+            if (op->inputs != oldInputs)
+                reconnectInputs(op, oldInputs);
+        }
+    }
+
+    void GraphObj::disconnectOperator(const Operator &op)
+    {
+        for (auto &input : op->getInputs())
+        {
+            if (!input)
+                continue;
+            input->removeTarget(op);
+            if (auto pred = input->getSource())
+                pred->removeSuccessors(op);
+        }
+        for (auto &output : op->getOutputs())
+        {
+            if (!output)
+                continue;
+            if (output->getSource() == op)
+                output->source.reset();
+            for (auto &succ : output->getTargets())
+                succ->removePredecessors(op);
+        }
+        op->predecessors.clear();
+        op->successors.clear();
+        removeOperator(op);
+    }
+
+    Tensor GraphObj::getTensor(int fuid) const
+    {
+        auto it = tensorIndex.find(fuid);
+        return it == tensorIndex.end() ? nullptr : tensors[it->second];
+    }
+
+    bool GraphObj::hasOperator(const Operator &op) const
+    {
+        auto it = op ? opIndex.find(op->getGuid()) : opIndex.end();
+        return it != opIndex.end() && ops[it->second] == op;
+    }
+
+    bool GraphObj::hasTensor(const Tensor &tensor) const
+    {
+        auto it = tensor ? tensorIndex.find(tensor->getFuid()) : tensorIndex.end();
+        return it != tensorIndex.end() && tensors[it->second] == tensor;
+    }
+
+    void GraphObj::removeOperator(Operator op)
+    {
+        if (!hasOperator(op))
+            return;
+        size_t pos = opIndex.at(op->getGuid());
+        opIndex.erase(op->getGuid());
+        invalidateViews();
+        if (deferCompaction)
+        {
+            ops[pos] = nullptr;
+            ++tombstones;
+            return;
+        }
+        ops.erase(ops.begin() + pos);
+        reindexOperators(pos);
+    }
+
+    void GraphObj::removeTensor(Tensor tensor)
+    {
+        if (!hasTensor(tensor))
+            return;
+        size_t pos = tensorIndex.at(tensor->getFuid());
+        tensorIndex.erase(tensor->getFuid());
+        invalidateViews();
+        if (deferCompaction)
+        {
+            tensors[pos] = nullptr;
+            ++tombstones;
+            return;
+        }
+        tensors.erase(tensors.begin() + pos);
+        reindexTensors(pos);
+    }
+
+    void GraphObj::compact()
+    {
+        if (tombstones == 0)
+            return;
+        ops.erase(std::remove(ops.begin(), ops.end(), nullptr), ops.end());
+        tensors.erase(std::remove(tensors.begin(), tensors.end(), nullptr),
+                      tensors.end());
+        tombstones = 0;
+        invalidateViews();
+        reindexOperators();
+        reindexTensors();
+    }
+
+    void GraphObj::reindexOperators(size_t from)
+    {
+        for (size_t i = from; i < ops.size(); ++i)
+            if (ops[i])
+                opIndex[ops[i]->getGuid()] = i;
+    }
+
+    void GraphObj::reindexTensors(size_t from)
+    {
+        for (size_t i = from; i < tensors.size(); ++i)
+            if (tensors[i])
+                tensorIndex[tensors[i]->getFuid()] = i;
     }
 
     void GraphObj::shape_infer()
     {
+        IT_LOG_SCOPE_TIMER("shape_infer");
         for (auto &op : ops)
         {
             auto ans = op->inferShape();
@@ -353,11 +537,10 @@ namespace infini
             {
                 auto newShape = ans.value()[i];
                 auto oldShape = oldOutputs[i]->getDims();
-                auto fuid = oldOutputs[i]->getFuid();
                 if (newShape != oldShape)
                 {
-                    auto tensor = this->getTensor(fuid);
-                    tensor->setShape(newShape);
+                    oldOutputs[i]->setShape(newShape);
+                    invalidateShapes();
                 }
             }
         }
@@ -365,24 +548,149 @@ namespace infini
 
     void GraphObj::dataMalloc()
     {
+        IT_LOG_SCOPE_TIMER("dataMalloc");
         // topological sorting first
         IT_ASSERT(topo_sort() == true);
-        size_t n = tensors.size();
-        vector<size_t> offsets(tensors.size(), 0);
-        for (size_t i = 0; i < n; ++i) { offsets[i] = allocator.alloc(tensors[i]->getBytes()); }
-        void* saddr = allocator.getPtr();
-        for (size_t i = 0; i < n; ++i) { tensors[i]->setDataBlob(make_ref<BlobObj>(runtime, reinterpret_cast<char*>(saddr) + offsets[i])); }
-        // =================================== 作业 ===================================
-        // TODO：利用 allocator 给计算图分配内存
-        // HINT: 获取分配好的内存指针后，可以调用 tensor 的 setDataBlob 函数给 tensor 绑定内存
-        // =================================== 作业 ===================================
-        
+        stashExecutionPlan();
+
+        vector<Shape> inputShapes;
+        for (const auto &input : getInputs())
+            inputShapes.emplace_back(input->getDims());
+        auto [entry, inserted] = shapePlans.try_emplace(inputShapes);
+        auto &shapePlan = entry->second;
+        if (inserted)
+        {
+            // Lifetimes in operator steps. Graph inputs and outputs are live
+            // for the whole run, so that the graph can be run again on the
+            // same inputs; intermediates are released after their last
+            // consumer. Operator ids of the dense graph are the steps, in
+            // topological order, even when the runtime runs independent
+            // operators concurrently: memory is then only reused from
+            // operators with lower ids, and the execution plan orders every
+            // reuse after the last users of the previous occupant.
+            const auto &g = getDenseGraph();
+            size_t nOps = g.numOps();
+            vector<MemoryPlanner::Buffer> buffers;
+            buffers.reserve(g.numTensors());
+            for (size_t i = 0; i < g.numTensors(); ++i)
+            {
+                auto source = g.source(i);
+                auto targets = g.targets(i);
+                // Constants have memory of their own.
+                MemoryPlanner::Buffer buffer{
+                    tensors[i]->isConstant() ? 0 : g.bytes(i), 0, nOps};
+                if (source != DenseGraph::None && !targets.empty() &&
+                    !isDesignatedOutput(tensors[i]))
+                {
+                    buffer.firstDef = source;
+                    buffer.lastUse = source;
+                    for (auto target : targets)
+                        buffer.lastUse = std::max<size_t>(buffer.lastUse, target);
+                }
+                buffers.emplace_back(buffer);
+            }
+            // Views take no memory of their own; the tensor owning the memory
+            // stays live as long as any view into it.
+            vector<bool> outputs(g.numTensors());
+            for (size_t i = 0; i < g.numTensors(); ++i)
+                outputs[i] = isDesignatedOutput(tensors[i]);
+            auto views = ViewPlanner::plan(g, outputs);
+            for (size_t i = 0; i < g.numTensors(); ++i)
+            {
+                auto base = views[i].base;
+                if (base == DenseGraph::None)
+                    continue;
+                buffers[base].firstDef =
+                    std::min(buffers[base].firstDef, buffers[i].firstDef);
+                buffers[base].lastUse =
+                    std::max(buffers[base].lastUse, buffers[i].lastUse);
+                buffers[i] = {0, 0, 0};
+            }
+
+            shapePlan.memory =
+                MemoryPlanner(runtime, allocator.getAlignment()).plan(buffers);
+            shapePlan.views = std::move(views);
+            IT_LOG_DEBUG("Memory plan: strategy "
+                         << MemoryPlanner::toString(shapePlan.memory.strategy)
+                         << ", peak " << shapePlan.memory.peak << " bytes");
+        }
+        else
+            IT_LOG_DEBUG("Reusing the memory plan of these input shapes");
+
+        // The arena only holds the current plan. It is reallocated when the
+        // plan outgrows it, and kept otherwise.
+        const auto &plan = shapePlan.memory;
+        const auto &views = shapePlan.views;
+        allocator.free(arenaOffset, arenaBytes);
+        arenaOffset = allocator.alloc(plan.peak);
+        arenaBytes = plan.peak;
+        auto saddr = reinterpret_cast<char *>(allocator.getPtr()) + arenaOffset;
+        for (size_t i = 0; i < tensors.size(); ++i)
+            tensors[i]->setDataBlob(
+                tensors[i]->isConstant()
+                    ? tensors[i]->getConstantBlob()
+                    : make_ref<BlobObj>(runtime, saddr + plan.offsets[i]));
+        for (size_t i = 0; i < tensors.size(); ++i)
+            if (views[i].base != DenseGraph::None)
+                tensors[i]->setView(tensors[views[i].base], views[i].offset,
+                                    views[i].strides);
+        plannedInputShapes = std::move(inputShapes);
+        if (shapePlan.arena == saddr)
+            executionPlan = std::move(shapePlan.executionPlan);
+        shapePlan.executionPlan.reset();
+
         allocator.info();
     }
 
+    void GraphObj::reshapeInputs(const vector<Shape> &shapes)
+    {
+        auto inputs = getInputs();
+        IT_ASSERT(inputs.size() == shapes.size());
+        bool changed = false;
+        for (size_t i = 0; i < inputs.size(); ++i)
+            if (inputs[i]->getDims() != shapes[i])
+            {
+                inputs[i]->setShape(shapes[i]);
+                changed = true;
+            }
+        if (changed)
+        {
+            invalidateShapes();
+            shape_infer();
+        }
+        dataMalloc();
+    }
+
+    void GraphObj::stashExecutionPlan()
+    {
+        if (executionPlan && plannedInputShapes)
+        {
+            auto &shapePlan = shapePlans.at(*plannedInputShapes);
+            shapePlan.executionPlan = std::move(executionPlan);
+            shapePlan.arena =
+                reinterpret_cast<char *>(allocator.getPtr()) + arenaOffset;
+        }
+        executionPlan.reset();
+    }
+
+    const DenseGraph &GraphObj::getDenseGraph() const
+    {
+        if (!dense)
+            dense = std::make_unique<DenseGraph>(ops, tensors);
+        return *dense;
+    }
+
+    const ExecutionPlan &GraphObj::getExecutionPlan() const
+    {
+        if (!executionPlan)
+            executionPlan = std::make_unique<ExecutionPlan>(
+                ops, getDenseGraph(), runtime.get());
+        return *executionPlan;
+    }
+
     Tensor GraphObj::addTensor(Shape dim, DataType dtype)
     {
-        return tensors.emplace_back(make_ref<TensorObj>(dim, dtype, runtime));
+        return addTensor(make_ref<TensorObj>(dim, dtype, runtime));
     }
 
     Tensor GraphObj::addTensor(const Tensor &tensor)
@@ -391,6 +699,8 @@ namespace infini
                   std::string("Tensor runtime mismatch: cannot add a tenosr in ") +
                       tensor->getRuntime()->toString() + " to " +
                       runtime->toString());
+        invalidateViews();
+        tensorIndex.try_emplace(tensor->getFuid(), tensors.size());
         tensors.emplace_back(tensor);
         return tensor;
     }
@@ -414,30 +724,28 @@ namespace infini
                         nullptr == tensor->getSource()));
             for (auto op : tensor->getTargets())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), op) != ops.end());
+                IT_ASSERT(hasOperator(op));
             }
             auto op = tensor->getSource();
-            IT_ASSERT(!(op && std::find(ops.begin(), ops.end(), op) == ops.end()));
+            IT_ASSERT(!(op && !hasOperator(op)));
         }
         for (auto op : ops)
         {
             for (auto tensor : op->getInputs())
             {
-                IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
-                          tensors.end());
+                IT_ASSERT(hasTensor(tensor));
             }
             for (auto tensor : op->getOutputs())
             {
-                IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
-                          tensors.end());
+                IT_ASSERT(hasTensor(tensor));
             }
             for (auto pre : op->getPredecessors())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), pre) != ops.end());
+                IT_ASSERT(hasOperator(pre));
             }
             for (auto suc : op->getSuccessors())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), suc) != ops.end());
+                IT_ASSERT(hasOperator(suc));
             }
         }
         std::set<UidBaseType> s;
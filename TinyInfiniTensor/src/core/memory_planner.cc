@@ -0,0 +1,133 @@
+#include "core/memory_planner.h"
+#include <algorithm>
+#include <numeric>
+
+namespace infini
+{
+
+    const char *MemoryPlanner::toString(Strategy strategy)
+    {
+        switch (strategy)
+        {
+        case Strategy::Sequential:
+            return "Sequential";
+        case Strategy::BySize:
+            return "BySize";
+        case Strategy::ByLifetime:
+            return "ByLifetime";
+        }
+        return "Unknown";
+    }
+
+    size_t MemoryPlanner::getAlignedSize(size_t size) const
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    MemoryPlanner::Plan MemoryPlanner::plan(const vector<Buffer> &buffers) const
+    {
+        Plan best = plan(buffers, Strategy::Sequential);
+        for (auto strategy : {Strategy::BySize, Strategy::ByLifetime})
+        {
+            Plan candidate = plan(buffers, strategy);
+            if (candidate.peak < best.peak)
+                best = std::move(candidate);
+        }
+        return best;
+    }
+
+    MemoryPlanner::Plan MemoryPlanner::plan(const vector<Buffer> &buffers,
+                                            Strategy strategy) const
+    {
+        for (const auto &buffer : buffers)
+            IT_ASSERT(buffer.firstDef <= buffer.lastUse);
+        if (strategy == Strategy::Sequential)
+            return planSequential(buffers);
+
+        vector<size_t> order(buffers.size());
+        std::iota(order.begin(), order.end(), 0);
+        auto lifetime = [&](size_t i)
+        { return buffers[i].lastUse - buffers[i].firstDef; };
+        // Ties fall back to the original order so that plans are stable.
+        if (strategy == Strategy::BySize)
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                             { return buffers[a].bytes > buffers[b].bytes; });
+        else
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                             { return lifetime(a) > lifetime(b); });
+        Plan ret = planGreedy(buffers, order);
+        ret.strategy = strategy;
+        return ret;
+    }
+
+    MemoryPlanner::Plan
+    MemoryPlanner::planSequential(const vector<Buffer> &buffers) const
+    {
+        size_t n = buffers.size(), nSteps = 0;
+        for (const auto &buffer : buffers)
+            nSteps = std::max(nSteps, buffer.lastUse + 1);
+        // Buffers defined and released at every step.
+        vector<vector<size_t>> defs(nSteps), frees(nSteps);
+        for (size_t i = 0; i < n; ++i)
+        {
+            defs[buffers[i].firstDef].emplace_back(i);
+            frees[buffers[i].lastUse].emplace_back(i);
+        }
+
+        Allocator allocator(runtime);
+        Plan ret{Strategy::Sequential, 0, vector<size_t>(n, 0)};
+        for (size_t step = 0; step < nSteps; ++step)
+        {
+            for (auto i : defs[step])
+                ret.offsets[i] = allocator.alloc(buffers[i].bytes);
+            for (auto i : frees[step])
+                allocator.free(ret.offsets[i], buffers[i].bytes);
+        }
+        ret.peak = allocator.getPeak();
+        return ret;
+    }
+
+    MemoryPlanner::Plan
+    MemoryPlanner::planGreedy(const vector<Buffer> &buffers,
+                              const vector<size_t> &order) const
+    {
+        Plan ret{Strategy::BySize, 0, vector<size_t>(buffers.size(), 0)};
+        // Buffers placed so far, as (offset, index), kept sorted by offset.
+        vector<std::pair<size_t, size_t>> placed;
+        vector<std::pair<size_t, size_t>> conflicts;
+        for (auto i : order)
+        {
+            const auto &buffer = buffers[i];
+            size_t size = getAlignedSize(buffer.bytes);
+            conflicts.clear();
+            for (const auto &[offset, j] : placed)
+                if (buffers[j].firstDef <= buffer.lastUse &&
+                    buffer.firstDef <= buffers[j].lastUse)
+                    conflicts.emplace_back(offset, j);
+
+            // Take the smallest gap between conflicting buffers that fits,
+            // or the space above all of them.
+            size_t best = SIZE_MAX, bestGap = SIZE_MAX, top = 0;
+            for (const auto &[offset, j] : conflicts)
+            {
+                if (offset >= top && offset - top >= size &&
+                    offset - top < bestGap)
+                {
+                    best = top;
+                    bestGap = offset - top;
+                }
+                top = std::max(top, offset + getAlignedSize(buffers[j].bytes));
+            }
+            if (best == SIZE_MAX)
+                best = top;
+
+            ret.offsets[i] = best;
+            ret.peak = std::max(ret.peak, best + size);
+            placed.insert(std::upper_bound(placed.begin(), placed.end(),
+                                           std::make_pair(best, i)),
+                          std::make_pair(best, i));
+        }
+        return ret;
+    }
+
+} // namespace infini
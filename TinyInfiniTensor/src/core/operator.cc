@@ -71,6 +71,24 @@ namespace infini
 
     optional<vector<Shape>> OperatorObj::inferShape() { return inferShape(inputs); }
 
+    vector<int> OperatorObj::getOpAttrVector() const
+    {
+        return {type.underlying()};
+    }
+
+    size_t OperatorObj::hash() const
+    {
+        // boost::hash_combine
+        size_t seed = 0;
+        auto combine = [&](size_t value)
+        { seed ^= value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2); };
+        for (int attr : getOpAttrVector())
+            combine(std::hash<int>()(attr));
+        for (const auto &input : inputs)
+            combine(std::hash<UidBaseType>()(input->getFuid()));
+        return seed;
+    }
+
     vector<DataType> OperatorObj::inferDataType(const TensorVec &inputs) const
     {
         auto dataType = inputs[0]->getDType();
@@ -0,0 +1,169 @@
+#include "core/perf_engine.h"
+#include "utils/thread_pool.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <nlohmann/json.hpp>
+
+namespace infini
+{
+    using json = nlohmann::json;
+
+    namespace
+    {
+        // Runs per candidate: one warmup, then the best of the timed ones.
+        constexpr int warmup = 1, repeat = 3;
+
+        double timeStep(const Kernel::Step &step)
+        {
+            for (int i = 0; i < warmup; ++i)
+                step();
+            double best = std::numeric_limits<double>::max();
+            for (int i = 0; i < repeat; ++i)
+            {
+                auto start = std::chrono::steady_clock::now();
+                step();
+                std::chrono::duration<double, std::milli> elapsed =
+                    std::chrono::steady_clock::now() - start;
+                best = std::min(best, elapsed.count());
+            }
+            return best;
+        }
+    } // namespace
+
+    Kernel::Step TunableKernel::prepare(const Operator &op,
+                                        const RuntimeObj *context) const
+    {
+        auto config = PerfEngine::getInstance().getConfig(*this, op, context);
+        return prepare(op, config, context);
+    }
+
+    PerfEngine::PerfEngine()
+    {
+        if (const char *env = std::getenv("INFINI_TUNE"))
+            tuning = std::strcmp(env, "0") != 0;
+        if (const char *env = std::getenv("INFINI_TUNE_CACHE"))
+        {
+            cachePath = env;
+            std::ifstream exists(cachePath);
+            if (exists && !load(cachePath))
+                IT_LOG_WARN("Ignoring unreadable tuning cache " << cachePath);
+        }
+    }
+
+    PerfEngine &PerfEngine::getInstance()
+    {
+        static PerfEngine instance;
+        return instance;
+    }
+
+    TuneConfig PerfEngine::getConfig(const TunableKernel &kernel,
+                                     const Operator &op,
+                                     const RuntimeObj *context)
+    {
+        auto configs = kernel.getTuneConfigs(op);
+        IT_ASSERT(!configs.empty());
+        if (configs.size() == 1)
+            return configs[0];
+        auto key = kernel.getTuneKey(op) + "/threads=" +
+                   std::to_string(ThreadPool::getInstance().numThreads());
+        if (auto record = getRecord(key))
+            if (std::find(configs.begin(), configs.end(), record->config) !=
+                configs.end())
+                return record->config;
+        if (!tuning)
+            return configs[0];
+
+        // Candidates run on the op's own tensors. Their outputs are
+        // overwritten by the op anyway before anything reads them.
+        Record best{configs[0], std::numeric_limits<double>::max()};
+        for (const auto &config : configs)
+        {
+            double time = timeStep(kernel.prepare(op, config, context));
+            IT_LOG_DEBUG("tune " << key << " config=" << vecToString(config)
+                                 << " ms=" << time);
+            if (time < best.time)
+                best = {config, time};
+        }
+        IT_LOG_INFO("Tuned " << key << ": config=" << vecToString(best.config)
+                             << " ms=" << best.time);
+        setRecord(key, best);
+        if (!cachePath.empty() && !save(cachePath))
+            IT_LOG_WARN("Cannot write tuning cache " << cachePath);
+        return best.config;
+    }
+
+    optional<PerfEngine::Record> PerfEngine::getRecord(const string &key) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = records.find(key);
+        if (it == records.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    void PerfEngine::setRecord(const string &key, const Record &record)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        records[key] = record;
+    }
+
+    size_t PerfEngine::size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return records.size();
+    }
+
+    void PerfEngine::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        records.clear();
+    }
+
+    bool PerfEngine::load(const string &path)
+    {
+        std::ifstream file(path);
+        if (!file)
+            return false;
+        json j = json::parse(file, nullptr, false);
+        if (j.is_discarded() || !j.contains("records") ||
+            !j["records"].is_array())
+            return false;
+        std::map<string, Record> loaded;
+        for (const auto &item : j["records"])
+        {
+            if (!item.contains("key") || !item.contains("config") ||
+                !item.contains("time") || !item["key"].is_string() ||
+                !item["config"].is_array() || !item["time"].is_number())
+                return false;
+            loaded[item["key"].get<string>()] = {
+                item["config"].get<TuneConfig>(), item["time"].get<double>()};
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto &[key, record] : loaded)
+            records[key] = record;
+        return true;
+    }
+
+    bool PerfEngine::save(const string &path) const
+    {
+        json j;
+        j["version"] = 1;
+        j["records"] = json::array();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto &[key, record] : records)
+                j["records"].push_back({{"key", key},
+                                        {"config", record.config},
+                                        {"time", record.time}});
+        }
+        std::ofstream file(path);
+        if (!file)
+            return false;
+        file << j.dump(2) << std::endl;
+        return bool(file);
+    }
+
+} // namespace infini
@@ -0,0 +1,430 @@
+#include "core/graph.h"
+#include "core/rewrite_rule.h"
+#include "operators/concat.h"
+#include "operators/fused_element_wise.h"
+#include "operators/matmul.h"
+#include "operators/quantize_linear.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace infini
+{
+
+    namespace
+    {
+
+        bool isIdentity(const vector<int> &perm)
+        {
+            for (size_t i = 0; i < perm.size(); ++i)
+                if (perm[i] != int(i))
+                    return false;
+            return true;
+        }
+
+        // Transpose(Transpose(x, p1), p2) == Transpose(x, p) with
+        // p[i] = p1[p2[i]]; an identity p cancels both.
+        bool foldTransposePair(GraphObj &graph, const Operator &op,
+                               OpVec &affected)
+        {
+            auto second = as<TransposeObj>(op);
+            auto mid = second->getInputs(0), out = second->getOutput();
+            auto first = as<TransposeObj>(mid->getSource());
+            if (!first || !graph.hasOperator(first))
+                return false;
+            auto x = first->getInputs(0);
+            auto p1 = first->getPermute(), p2 = second->getPermute();
+            vector<int> perm(p2.size());
+            for (size_t i = 0; i < perm.size(); ++i)
+                perm[i] = p1[p2[i]];
+
+            if (isIdentity(perm))
+            {
+                // A graph output must keep its tensor, so it can only be
+                // rewired when something consumes it.
+                auto consumers = out->getTargets();
+                if (consumers.empty() || graph.isDesignatedOutput(out))
+                    return false;
+                graph.replaceAllUses(out, x);
+                graph.disconnectOperator(second);
+                graph.removeTensor(out);
+                affected.insert(affected.end(), consumers.begin(),
+                                consumers.end());
+            }
+            else
+            {
+                graph.disconnectOperator(second);
+                auto merged = graph.addOpWithOutputs<TransposeObj>(x, out, perm);
+                affected.emplace_back(merged);
+                for (auto &consumer : out->getTargets())
+                    affected.emplace_back(consumer);
+            }
+
+            // The first transpose is gone only if nothing else reads it.
+            if (mid->getTargets().empty() && !graph.isDesignatedOutput(mid))
+            {
+                graph.disconnectOperator(first);
+                graph.removeTensor(mid);
+            }
+            if (auto producer = x->getSource())
+                affected.emplace_back(producer);
+            return true;
+        }
+
+        // MatMul(Transpose(x, swap of the last two dims), ...) reads x with
+        // the corresponding trans flag flipped.
+        bool foldTransposeIntoMatmul(GraphObj &graph, const Operator &op,
+                                     OpVec &affected)
+        {
+            auto matmul = as<MatmulObj>(op);
+            for (size_t i = 0; i < 2; ++i)
+            {
+                auto input = matmul->getInputs(i);
+                auto transpose = as<TransposeObj>(input->getSource());
+                if (!transpose || !graph.hasOperator(transpose))
+                    continue;
+                auto perm = transpose->getPermute();
+                size_t rank = perm.size();
+                if (rank < 2 || perm[rank - 2] != int(rank - 1) ||
+                    perm[rank - 1] != int(rank - 2) ||
+                    !isIdentity(vector<int>(perm.begin(), perm.end() - 2)))
+                    continue;
+
+                if (i == 0)
+                    matmul->setTransA(!matmul->getTransA());
+                else
+                    matmul->setTransB(!matmul->getTransB());
+                graph.replaceInput(matmul, i, transpose->getInputs(0));
+                if (input->getTargets().empty() &&
+                    !graph.isDesignatedOutput(input))
+                {
+                    graph.disconnectOperator(transpose);
+                    graph.removeTensor(input);
+                }
+                affected.emplace_back(matmul);
+                return true;
+            }
+            return false;
+        }
+
+        // The DequantizeLinear producing `t`, or nullptr.
+        Ref<DequantizeLinearObj> dequantizeOf(GraphObj &graph, const Tensor &t)
+        {
+            auto dq = as<DequantizeLinearObj>(t->getSource());
+            return dq && graph.hasOperator(dq) ? dq : nullptr;
+        }
+
+        // Replaces `op`, whose inputs are produced by `dqs`, with the
+        // operator built by `make` on the quantized values followed by a
+        // DequantizeLinear with `params` writing the output of `op`. The
+        // dequantizations nothing else reads are removed.
+        template <typename Make>
+        void sinkDequantize(GraphObj &graph, const Operator &op,
+                            const vector<Ref<DequantizeLinearObj>> &dqs,
+                            const QuantParams &params, Make make,
+                            OpVec &affected)
+        {
+            auto out = op->getOutput();
+            graph.disconnectOperator(op);
+            Operator moved = make();
+            auto dq = graph.addOpWithOutputs<DequantizeLinearObj>(
+                moved->getOutput(), out, params);
+            affected.emplace_back(moved);
+            affected.emplace_back(dq);
+            for (auto &consumer : out->getTargets())
+                affected.emplace_back(consumer);
+            for (auto &old : dqs)
+            {
+                if (!graph.hasOperator(old))
+                    continue;
+                auto mid = old->getOutput();
+                if (mid->getTargets().empty() && !graph.isDesignatedOutput(mid))
+                {
+                    graph.disconnectOperator(old);
+                    graph.removeTensor(mid);
+                }
+                if (auto producer = old->getInputs(0)->getSource())
+                    affected.emplace_back(producer);
+            }
+        }
+
+        // Per-tensor parameters with a positive scale, so that the
+        // dequantization is increasing.
+        bool isMonotonic(const QuantParams &params)
+        {
+            return params.isPerTensor() && params.scales[0] > 0;
+        }
+
+        // Transpose(DQ(q)) == DQ(Transpose(q)), the channel axis following
+        // its dimension.
+        bool sinkDequantizeTranspose(GraphObj &graph, const Operator &op,
+                                     OpVec &affected)
+        {
+            auto transpose = as<TransposeObj>(op);
+            auto dq = dequantizeOf(graph, transpose->getInputs(0));
+            if (!dq)
+                return false;
+            auto perm = transpose->getPermute();
+            auto params = dq->getParams();
+            if (!params.isPerTensor())
+                params.axis =
+                    std::find(perm.begin(), perm.end(), params.axis) -
+                    perm.begin();
+            auto q = dq->getInputs(0);
+            sinkDequantize(
+                graph, op, {dq}, params, [&]
+                { return graph.addOp<TransposeObj>(q, nullptr, perm); },
+                affected);
+            return true;
+        }
+
+        // The quantized value of a Clip bound, nullopt when the bound does
+        // not clip any quantized value. Fails when the bound falls between
+        // two quantized values, which the output could not represent.
+        bool quantizeBound(std::optional<float> bound, bool isMin,
+                           const QuantParams &params, DataType dtype,
+                           std::optional<float> &result)
+        {
+            result.reset();
+            if (!bound)
+                return true;
+            double qmin = std::numeric_limits<int32_t>::lowest(),
+                   qmax = std::numeric_limits<int32_t>::max();
+            if (dtype == DataType::Int8)
+                qmin = -128, qmax = 127;
+            else if (dtype == DataType::UInt8)
+                qmin = 0, qmax = 255;
+            float scale = params.scales[0];
+            int zero = params.zeroPoints[0];
+            if (std::isnan(*bound))
+                return false;
+            if (isMin ? *bound <= float(qmin - zero) * scale
+                      : *bound >= float(qmax - zero) * scale)
+                return true;
+            double q = std::nearbyint(double(*bound) / scale) + zero;
+            if (q < qmin || q > qmax ||
+                float(int(q) - zero) * scale != *bound)
+                return false;
+            result = float(q);
+            return true;
+        }
+
+        // Relu(DQ(q)) == DQ(Clip(q, zero point)) and Clip(DQ(q), lo, hi) ==
+        // DQ(Clip(q, ...)) when the bounds are quantized values.
+        bool sinkDequantizeClip(GraphObj &graph, const Operator &op,
+                                OpVec &affected)
+        {
+            auto dq = dequantizeOf(graph, op->getInputs(0));
+            if (!dq || !isMonotonic(dq->getParams()))
+                return false;
+            const auto &params = dq->getParams();
+            auto q = dq->getInputs(0);
+            std::optional<float> lo, hi;
+            if (op->getOpType() == OpType::Relu)
+                lo = float(params.zeroPoints[0]);
+            else
+            {
+                auto clip = as<ClipObj>(op);
+                if (!quantizeBound(clip->getMin(), true, params,
+                                   q->getDType(), lo) ||
+                    !quantizeBound(clip->getMax(), false, params,
+                                   q->getDType(), hi))
+                    return false;
+            }
+            sinkDequantize(
+                graph, op, {dq}, params, [&]
+                { return graph.addOp<ClipObj>(q, nullptr, lo, hi); },
+                affected);
+            return true;
+        }
+
+        // Concat(DQ(q0), DQ(q1), ...) == DQ(Concat(q0, q1, ...)) when every
+        // input is quantized alike.
+        bool sinkDequantizeConcat(GraphObj &graph, const Operator &op,
+                                  OpVec &affected)
+        {
+            auto concat = as<ConcatObj>(op);
+            vector<Ref<DequantizeLinearObj>> dqs;
+            TensorVec qs;
+            for (const auto &input : concat->getInputs())
+            {
+                auto dq = dequantizeOf(graph, input);
+                if (!dq)
+                    return false;
+                if (!dqs.empty() &&
+                    (!(dq->getParams() == dqs.front()->getParams()) ||
+                     !(dq->getDType() == dqs.front()->getDType())))
+                    return false;
+                dqs.emplace_back(dq);
+                qs.emplace_back(dq->getInputs(0));
+            }
+            const auto &params = dqs.front()->getParams();
+            if (!params.isPerTensor() && params.axis == concat->getDim())
+                return false;
+            int dim = concat->getDim();
+            sinkDequantize(
+                graph, op, dqs, params, [&]
+                { return graph.addOp<ConcatObj>(qs, nullptr, dim); },
+                affected);
+            return true;
+        }
+
+        // MatMul(DQ(a), DQ(b)) == DQ(MatMul(a, b)) computed on Int8 with
+        // Int32 accumulation, for symmetric quantization with a per-tensor
+        // scale for A and per-tensor or per-column scales for B.
+        bool sinkDequantizeMatmul(GraphObj &graph, const Operator &op,
+                                  OpVec &affected)
+        {
+            auto matmul = as<MatmulObj>(op);
+            auto dqA = dequantizeOf(graph, matmul->getInputs(0));
+            auto dqB = dequantizeOf(graph, matmul->getInputs(1));
+            if (!dqA || !dqB || !(dqA->getDType() == DataType::Int8) ||
+                !(dqB->getDType() == DataType::Int8))
+                return false;
+            const auto &pa = dqA->getParams(), &pb = dqB->getParams();
+            auto isSymmetric = [](const QuantParams &p)
+            {
+                return std::all_of(p.zeroPoints.begin(), p.zeroPoints.end(),
+                                   [](int z) { return z == 0; });
+            };
+            int rankB = matmul->getInputs(1)->getRank();
+            int axisN = matmul->getTransB() ? rankB - 2 : rankB - 1;
+            if (!pa.isPerTensor() || !isSymmetric(pa) || !isSymmetric(pb) ||
+                (!pb.isPerTensor() && pb.axis != axisN))
+                return false;
+
+            QuantParams params;
+            for (float scale : pb.scales)
+                params.scales.emplace_back(pa.scales[0] * scale);
+            params.zeroPoints.assign(pb.scales.size(), 0);
+            params.axis = matmul->getOutput()->getRank() - 1;
+            auto a = dqA->getInputs(0), b = dqB->getInputs(0);
+            bool transA = matmul->getTransA(), transB = matmul->getTransB();
+            sinkDequantize(
+                graph, op, {dqA, dqB}, params, [&]
+                {
+                    return graph.addOp<MatmulObj>(a, b, nullptr, transA,
+                                                  transB);
+                },
+                affected);
+            return true;
+        }
+
+        // Merges the element-wise producer of an input into the element-wise
+        // `op` when `op` is the only reader of the intermediate and the
+        // intermediate has the output shape, so chains collapse one edge at
+        // a time into a single FusedElementWise operator.
+        bool fuseElementWise(GraphObj &graph, const Operator &op,
+                             OpVec &affected)
+        {
+            using Fused = FusedElementWiseObj;
+            if (!Fused::isFusible(op))
+                return false;
+            auto out = op->getOutput();
+            auto opInputs = op->getInputs();
+            for (const auto &mid : opInputs)
+            {
+                auto producer = mid->getSource();
+                if (!producer || !graph.hasOperator(producer) ||
+                    !Fused::isFusible(producer) ||
+                    mid->getDims() != out->getDims() ||
+                    graph.isDesignatedOutput(mid))
+                    continue;
+                auto readers = mid->getTargets();
+                if (!std::all_of(readers.begin(), readers.end(),
+                                 [&](const Operator &r) { return r == op; }))
+                    continue;
+
+                // Inputs of the fused operator, without duplicates
+                TensorVec inputs;
+                auto slotOf = [&](const Tensor &t)
+                {
+                    auto it = std::find(inputs.begin(), inputs.end(), t);
+                    if (it != inputs.end())
+                        return int(it - inputs.begin());
+                    inputs.emplace_back(t);
+                    return int(inputs.size() - 1);
+                };
+                vector<int> producerSlots, opSlots;
+                for (const auto &t : producer->getInputs())
+                    producerSlots.emplace_back(slotOf(t));
+                for (const auto &t : opInputs)
+                    opSlots.emplace_back(t == mid ? -1 : slotOf(t));
+
+                // Producer instructions first, then those of `op` reading the
+                // producer result in place of `mid`
+                auto producerProgram = Fused::programOf(producer);
+                auto opProgram = Fused::programOf(op);
+                int nIn = inputs.size();
+                int nProducerIn = producerSlots.size(), nOpIn = opSlots.size();
+                int producerResult = nIn + producerProgram.size() - 1;
+                int opBase = nIn + producerProgram.size();
+                auto remapProducer = [&](int slot)
+                {
+                    if (slot < 0)
+                        return slot;
+                    return slot < nProducerIn ? producerSlots[slot]
+                                              : nIn + slot - nProducerIn;
+                };
+                auto remapOp = [&](int slot)
+                {
+                    if (slot < 0)
+                        return slot;
+                    if (slot < nOpIn)
+                        return opSlots[slot] < 0 ? producerResult : opSlots[slot];
+                    return opBase + slot - nOpIn;
+                };
+                vector<Fused::Instruction> program;
+                for (auto instr : producerProgram)
+                {
+                    instr.a = remapProducer(instr.a);
+                    instr.b = remapProducer(instr.b);
+                    program.emplace_back(instr);
+                }
+                for (auto instr : opProgram)
+                {
+                    instr.a = remapOp(instr.a);
+                    instr.b = remapOp(instr.b);
+                    program.emplace_back(instr);
+                }
+
+                graph.disconnectOperator(op);
+                graph.disconnectOperator(producer);
+                graph.removeTensor(mid);
+                auto fused = graph.addOpWithOutputs<FusedElementWiseObj>(
+                    inputs, out, program);
+                affected.emplace_back(fused);
+                for (auto &consumer : out->getTargets())
+                    affected.emplace_back(consumer);
+                return true;
+            }
+            return false;
+        }
+
+    } // namespace
+
+} // namespace infini
+
+REGISTER_REWRITE_RULE(OpType::Transpose, foldTransposePair,
+                      "FoldTransposePair");
+REGISTER_REWRITE_RULE(OpType::MatMul, foldTransposeIntoMatmul,
+                      "FoldTransposeIntoMatmul");
+REGISTER_REWRITE_RULE(OpType::Transpose, sinkDequantizeTranspose,
+                      "SinkDequantizeTranspose");
+REGISTER_REWRITE_RULE(OpType::Relu, sinkDequantizeClip, "SinkDequantizeClip");
+REGISTER_REWRITE_RULE(OpType::Clip, sinkDequantizeClip, "SinkDequantizeClip");
+REGISTER_REWRITE_RULE(OpType::Concat, sinkDequantizeConcat,
+                      "SinkDequantizeConcat");
+REGISTER_REWRITE_RULE(OpType::MatMul, sinkDequantizeMatmul,
+                      "SinkDequantizeMatmul");
+REGISTER_REWRITE_RULE(OpType::Add, fuseElementWise, "FuseElementWise");
+REGISTER_REWRITE_RULE(OpType::Sub, fuseElementWise, "FuseElementWise");
+REGISTER_REWRITE_RULE(OpType::Mul, fuseElementWise, "FuseElementWise");
+REGISTER_REWRITE_RULE(OpType::Div, fuseElementWise, "FuseElementWise");
+REGISTER_REWRITE_RULE(OpType::Relu, fuseElementWise, "FuseElementWise");
+REGISTER_REWRITE_RULE(OpType::Clip, fuseElementWise, "FuseElementWise");
+REGISTER_REWRITE_RULE(OpType::Cast, fuseElementWise, "FuseElementWise");
+REGISTER_REWRITE_RULE(OpType::FusedElementWise, fuseElementWise,
+                      "FuseElementWise");
@@ -1,36 +1,87 @@
 #include "core/runtime.h"
 #include "core/blob.h"
-#include "core/kernel.h"
 #include "core/graph.h"
 #include "core/kernel.h"
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define INFINI_HAS_MMAP 1
+#else
+#define INFINI_HAS_MMAP 0
+#endif
+
 namespace infini
 {
     void NativeCpuRuntimeObj::run(const Graph &graph) const
     {
-        const auto &kernelRegistry = KernelRegistry::getInstance();
-
-        for (auto &op : graph->getOperators())
-        {
-            auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
-            Kernel *kernel = kernelRegistry.getKernel(kernelAttrs);
-            kernel->compute(op, this);
-        }
+        IT_LOG_SCOPE_TIMER("run");
+        // Kernels are resolved once per graph, shapes and memory plan.
+        graph->getExecutionPlan().run();
     }
 
     string NativeCpuRuntimeObj::toString() const { return "CPU Runtime"; }
 
+    void NativeCpuRuntimeObj::setAlignment(size_t bytes)
+    {
+        IT_ASSERT(bytes >= sizeof(uint64_t) && (bytes & (bytes - 1)) == 0,
+                  "Alignment must be a power of two of at least 8 bytes");
+        alignment = bytes;
+    }
+
     void NativeCpuRuntimeObj::dealloc(void *ptr)
     {
-        return free(ptr);
+        if (ptr == nullptr)
+            return;
+#if INFINI_HAS_MMAP
+        {
+            std::lock_guard<std::mutex> lock(mappedMutex);
+            auto it = mapped.find(ptr);
+            if (it != mapped.end())
+            {
+                munmap(ptr, it->second);
+                mapped.erase(it);
+                return;
+            }
+        }
+#endif
+        free(ptr);
     }
 
     void *NativeCpuRuntimeObj::alloc(size_t size)
     {
-        return calloc((size + sizeof(uint64_t) - 1) / sizeof(uint64_t),
-                      sizeof(uint64_t));
+        size = std::max<size_t>(size, 1);
+#if INFINI_HAS_MMAP
+        // Anonymous mappings are page aligned and zero filled by the kernel
+        // on first touch, so they are never cleared here.
+        if (hugePages && size >= hugePageThreshold &&
+            alignment <= size_t(sysconf(_SC_PAGESIZE)))
+        {
+            void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr != MAP_FAILED)
+            {
+#ifdef MADV_HUGEPAGE
+                madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+                std::lock_guard<std::mutex> lock(mappedMutex);
+                mapped.emplace(ptr, size);
+                return ptr;
+            }
+        }
+#endif
+        void *ptr = nullptr;
+        IT_ASSERT(posix_memalign(&ptr, alignment, size) == 0,
+                  "Out of memory allocating " + std::to_string(size) +
+                      " bytes");
+        if (zeroInit)
+            std::memset(ptr, 0, size);
+        return ptr;
     }
 
 } // namespace infini
@@ -9,7 +9,8 @@ namespace infini {
 
     TensorObj::TensorObj(Shape shape_, DataType dtype, Runtime runtime)
         : dim(shape_.size()), dtype(dtype), runtime(runtime), shape(std::move(shape_)),
-          _size(std::accumulate(shape.begin(), shape.end(), 1, std::multiplies{})) {}
+          _size(std::accumulate(shape.begin(), shape.end(), 1, std::multiplies{})),
+          strides(contiguousStrides(shape)) {}
 
     string TensorObj::toString() const
     {
@@ -22,7 +23,7 @@ namespace infini {
         string ret = "Tensor " + std::to_string(guid) + ", Fuid " +
                      std::to_string(fuid) + ", shape " + vecToString(shape) +
                      ", dtype " + dtype.toString() + ", " + runtime->toString() +
-                     ", " + ss.str() + "\n";
+                     ", " + ss.str() + (constant ? ", constant" : "") + "\n";
         vector<UidBaseType> targetGuids;
         for (const auto &op : targets)
             targetGuids.emplace_back(op.lock()->getGuid());
@@ -39,6 +40,28 @@ void TensorObj::setShape(Shape shape_) {
     size_t size = std::accumulate(shape.begin(), shape.end(), 1,
                                   [](auto acc, auto x) { return acc * x; });
     _size = size;
+    strides = contiguousStrides(shape);
+}
+
+vector<size_t> TensorObj::contiguousStrides(const Shape &shape) {
+    vector<size_t> ret(shape.size());
+    size_t stride = 1;
+    for (size_t i = shape.size(); i-- > 0;) {
+        ret[i] = stride;
+        stride *= shape[i];
+    }
+    return ret;
+}
+
+bool TensorObj::isContiguous() const {
+    // Steps of extent-1 dimensions never matter.
+    size_t stride = 1;
+    for (size_t i = shape.size(); i-- > 0;) {
+        if (shape[i] != 1 && strides[i] != stride)
+            return false;
+        stride *= shape[i];
+    }
+    return true;
 }
 
 void TensorObj::printData() const {
@@ -76,6 +99,7 @@ bool TensorObj::equalData(const Tensor &rhs, double relativeError) const {
     IT_ASSERT(getDType() == rhs->getDType());
     IT_ASSERT(runtime->isCpu());
     IT_ASSERT(rhs->getRuntime()->isCpu());
+    IT_ASSERT(isContiguous() && rhs->isContiguous());
     if (size() != rhs->size())
         return false;
 
@@ -111,6 +135,34 @@ void TensorObj::setData(
     generator(getRawDataPtr<void *>(), size(), dtype);
 }
 
-void TensorObj::setDataBlob(const Blob &blob) { this->data = blob; }
+void TensorObj::setDataBlob(const Blob &blob) {
+    data = blob;
+    viewBase = nullptr;
+    strides = contiguousStrides(shape);
+}
+
+void TensorObj::setConstant(
+    const std::function<void(void *, size_t, DataType)> &generator) {
+    void *ptr = runtime->alloc(getBytes());
+    constant = std::shared_ptr<void>(
+        ptr, [runtime = runtime](void *p) { runtime->dealloc(p); });
+    setDataBlob(getConstantBlob());
+    generator(ptr, size(), dtype);
+}
+
+Blob TensorObj::getConstantBlob() const {
+    IT_ASSERT(constant != nullptr);
+    return make_ref<BlobObj>(runtime, constant.get());
+}
+
+void TensorObj::setView(const Ref<TensorObj> &base, size_t offset,
+                        vector<size_t> strides_) {
+    IT_ASSERT(base->data != nullptr && base->viewBase == nullptr);
+    IT_ASSERT(base->dtype == dtype && strides_.size() == shape.size());
+    data = make_ref<BlobObj>(runtime, base->getRawDataPtr<char *>() +
+                                          offset * dtype.getSize());
+    viewBase = base;
+    strides = std::move(strides_);
+}
 
 }; // namespace infini
@@ -0,0 +1,167 @@
+#include "core/view_planner.h"
+#include "operators/concat.h"
+#include "operators/transpose.h"
+#include <algorithm>
+#include <functional>
+
+namespace infini
+{
+    namespace
+    {
+        using Id = DenseGraph::Id;
+
+        // How a tensor lives inside its parent, before views of views are
+        // resolved.
+        struct Link
+        {
+            Id parent = DenseGraph::None;
+            // Element offset of a Concat slice.
+            size_t offset = 0;
+            // Permutation of a Transpose, empty for a Concat slice.
+            vector<int> permute;
+        };
+
+        void linkConcatInputs(const DenseGraph &g, Id op, vector<Link> &links)
+        {
+            auto concat = dynamic_cast<const ConcatObj *>(g.getOp(op));
+            const auto &outDims = concat->getOutput()->getDims();
+            for (int i = 0; i < concat->getDim(); ++i)
+                if (outDims[i] != 1)
+                    return;
+            auto output = g.outputs(op)[0];
+            auto inputs = g.inputs(op);
+            if (inputs.size() != concat->getInputs().size())
+                return;
+            size_t offset = 0;
+            for (size_t i = 0; i < inputs.size(); ++i)
+            {
+                auto input = inputs[i];
+                // An input used twice cannot sit in both slices, and
+                // constants keep memory of their own.
+                bool unique = std::count(inputs.begin(), inputs.end(), input) == 1;
+                if (unique && input != output &&
+                    !g.getTensor(input)->isConstant() &&
+                    links[input].parent == DenseGraph::None)
+                    links[input] = {output, offset, {}};
+                offset += g.getTensor(input)->size();
+            }
+        }
+
+        void linkTransposeOutput(const DenseGraph &g, Id op,
+                                 const vector<bool> &outputs,
+                                 vector<Link> &links)
+        {
+            auto inputs = g.inputs(op);
+            auto output = g.outputs(op)[0];
+            auto targets = g.targets(output);
+            if (inputs.size() != 1 || targets.empty() || outputs[output] ||
+                links[output].parent != DenseGraph::None)
+                return;
+            for (auto target : targets)
+            {
+                const auto &targetInputs = g.getOp(target)->getInputs();
+                for (size_t i = 0; i < targetInputs.size(); ++i)
+                    if (targetInputs[i].get() == g.getTensor(output) &&
+                        !g.getOp(target)->acceptsStridedInput(i))
+                        return;
+            }
+            auto transpose = dynamic_cast<const TransposeObj *>(g.getOp(op));
+            links[output] = {inputs[0], 0, transpose->getPermute()};
+        }
+
+        void linkInPlaceInput(const DenseGraph &g, Id op,
+                              const vector<bool> &hasViews,
+                              const vector<bool> &graphOutputs,
+                              vector<Link> &links)
+        {
+            auto outputs = g.outputs(op);
+            if (outputs.size() != 1)
+                return;
+            auto *obj = g.getOp(op);
+            auto *output = g.getTensor(outputs[0]);
+            auto predecessors = g.predecessors(op);
+            const auto &inputs = obj->getInputs();
+            for (size_t i = 0; i < inputs.size(); ++i)
+            {
+                auto input = g.tensorId(inputs[i].get());
+                // Graph inputs are kept intact for the next run, graph
+                // outputs for the caller, and memory that other tensors live
+                // in is still read through them.
+                if (!obj->canOverwriteInput(i) || input == DenseGraph::None ||
+                    input == outputs[0] || g.source(input) == DenseGraph::None ||
+                    graphOutputs[input] ||
+                    hasViews[input] || links[input].parent != DenseGraph::None ||
+                    inputs[i]->getDims() != output->getDims() ||
+                    !(inputs[i]->getDType() == output->getDType()))
+                    continue;
+                // The input must die here. Other readers are only known to be
+                // done if they produce inputs of this operator.
+                bool dies = true;
+                for (auto target : g.targets(input))
+                    dies &= target == op ||
+                            std::binary_search(predecessors.begin(),
+                                               predecessors.end(), target);
+                if (dies)
+                {
+                    links[input] = {outputs[0], 0, {}};
+                    return;
+                }
+            }
+        }
+    } // namespace
+
+    vector<ViewPlanner::View> ViewPlanner::plan(const DenseGraph &g,
+                                                const vector<bool> &outputs)
+    {
+        size_t nTensors = g.numTensors();
+        vector<Link> links(nTensors);
+        for (Id op = 0; op < g.numOps(); ++op)
+        {
+            auto type = g.getOp(op)->getOpType();
+            if (type == OpType::Concat)
+                linkConcatInputs(g, op, links);
+            else if (type == OpType::Transpose)
+                linkTransposeOutput(g, op, outputs, links);
+        }
+        vector<bool> hasViews(nTensors, false);
+        for (const auto &link : links)
+            if (link.parent != DenseGraph::None)
+                hasViews[link.parent] = true;
+        for (Id op = 0; op < g.numOps(); ++op)
+            linkInPlaceInput(g, op, hasViews, outputs, links);
+
+        vector<View> views(nTensors);
+        vector<bool> resolved(nTensors, false);
+        std::function<void(Id)> resolve = [&](Id tensor)
+        {
+            if (resolved[tensor])
+                return;
+            resolved[tensor] = true;
+            auto &view = views[tensor];
+            const auto &link = links[tensor];
+            if (link.parent == DenseGraph::None)
+            {
+                view.strides =
+                    TensorObj::contiguousStrides(g.getTensor(tensor)->getDims());
+                return;
+            }
+            resolve(link.parent);
+            const auto &parent = views[link.parent];
+            view.base = parent.base == DenseGraph::None ? link.parent
+                                                        : parent.base;
+            view.offset = parent.offset + link.offset;
+            if (link.permute.empty())
+                // Concat slices and inputs overwritten in place live in
+                // contiguous outputs, which are never strided views.
+                view.strides =
+                    TensorObj::contiguousStrides(g.getTensor(tensor)->getDims());
+            else
+                for (auto axis : link.permute)
+                    view.strides.emplace_back(parent.strides[axis]);
+        };
+        for (Id tensor = 0; tensor < nTensors; ++tensor)
+            resolve(tensor);
+        return views;
+    }
+
+} // namespace infini
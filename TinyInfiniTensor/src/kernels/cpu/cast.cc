@@ -0,0 +1,127 @@
+#include "operators/unary.h"
+#include "core/kernel.h"
+#include "kernels/cpu/simd.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cstring>
+
+namespace infini
+{
+    class NativeCast : public CpuKernelWithoutConfig
+    {
+        // Elements handled per task when splitting work across threads.
+        static constexpr size_t grain = 1 << 14;
+
+        // Conversions without a vector kernel. Following ONNX, float to
+        // integer truncates and saturates, and narrowing between integers
+        // keeps the low bits.
+        template <typename To, typename From>
+        static void convert(To *out, const From *in, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                if constexpr (std::is_floating_point_v<From> &&
+                              std::is_integral_v<To>)
+                    out[i] = float_to_int<To>(in[i]);
+                else
+                    out[i] = static_cast<To>(in[i]);
+            }
+        }
+
+        template <typename T>
+        static void copy(T *out, const T *in, size_t n)
+        {
+            std::memcpy(out, in, n * sizeof(T));
+        }
+
+        template <typename To, typename From>
+        static Step makeStep(const Operator &op,
+                             void (*kernel)(To *, const From *, size_t))
+        {
+            auto inptr = op->getInputs(0)->getRawDataPtr<From *>();
+            auto outptr = op->getOutput()->getRawDataPtr<To *>();
+            auto n = op->getOutput()->size();
+            size_t nTasks = (n + grain - 1) / grain;
+            return [=]
+            {
+                parallel_for(nTasks, [&](size_t first, size_t last)
+                             {
+                                 size_t begin = first * grain;
+                                 kernel(outptr + begin, inptr + begin,
+                                        std::min(last * grain, n) - begin);
+                             });
+            };
+        }
+
+        Step prepare(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<CastObj>(_op);
+            const auto &simd = get_simd_kernels().cast;
+            switch (op->getType())
+            {
+            case CastType::Float2Float16:
+                return makeStep(_op, simd.f32ToF16);
+            case CastType::Float2Int64:
+                return makeStep(_op, convert<int64_t, float>);
+            case CastType::Float2Int32:
+                return makeStep(_op, simd.f32ToI32);
+            case CastType::Float2Int16:
+                return makeStep(_op, convert<int16_t, float>);
+            case CastType::Float2Int8:
+                return makeStep(_op, convert<int8_t, float>);
+            case CastType::Float2BFloat16:
+                return makeStep(_op, simd.f32ToBf16);
+            case CastType::Int322Float:
+                return makeStep(_op, simd.i32ToF32);
+            case CastType::Int322Int8:
+                return makeStep(_op, convert<int8_t, int32_t>);
+            case CastType::Int322Int16:
+                return makeStep(_op, convert<int16_t, int32_t>);
+            case CastType::Int322Int64:
+                return makeStep(_op, convert<int64_t, int32_t>);
+            case CastType::Int162Float:
+                return makeStep(_op, convert<float, int16_t>);
+            case CastType::Int162Int32:
+                return makeStep(_op, convert<int32_t, int16_t>);
+            case CastType::Int82Float:
+                return makeStep(_op, convert<float, int8_t>);
+            case CastType::Int82Int16:
+                return makeStep(_op, convert<int16_t, int8_t>);
+            case CastType::Int82Int32:
+                return makeStep(_op, convert<int32_t, int8_t>);
+            case CastType::Uint82Float:
+                return makeStep(_op, convert<float, uint8_t>);
+            case CastType::Uint82Int32:
+                return makeStep(_op, convert<int32_t, uint8_t>);
+            case CastType::Uint82Int64:
+                return makeStep(_op, convert<int64_t, uint8_t>);
+            case CastType::Int642Int32:
+                return makeStep(_op, convert<int32_t, int64_t>);
+            case CastType::Int642Uint32:
+                return makeStep(_op, convert<uint32_t, int64_t>);
+            case CastType::Int642Float:
+                return makeStep(_op, convert<float, int64_t>);
+            case CastType::Uint322Int64:
+                return makeStep(_op, convert<int64_t, uint32_t>);
+            case CastType::Float162Float:
+                return makeStep(_op, simd.f16ToF32);
+            case CastType::BFloat162Float:
+                return makeStep(_op, simd.bf16ToF32);
+            case CastType::Float2Float:
+                return makeStep(_op, copy<float>);
+            default:
+                IT_TODO_HALT();
+            }
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            prepare(_op, context)();
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::Cast, NativeCast, "Cast_CPU");
+
+}; // namespace infini
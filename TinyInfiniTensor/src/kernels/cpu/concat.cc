@@ -1,61 +1,143 @@
 #include "operators/concat.h"
 #include "core/kernel.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace infini {
 
+namespace {
+
+// Bytes copied per task when splitting work across threads.
+constexpr size_t grain = 64 << 10;
+// Outputs at least this large bypass the caches with nontemporal stores:
+// they would not stay cached anyway and would evict the inputs being read.
+constexpr size_t streamThreshold = 8 << 20;
+
+// memcpy with nontemporal stores where available. The caller fences.
+void streamCopy(char *dst, const char *src, size_t bytes) {
+#if defined(__SSE2__)
+    size_t head = std::min(bytes, (16 - reinterpret_cast<uintptr_t>(dst) % 16) % 16);
+    std::memcpy(dst, src, head);
+    size_t i = head;
+    for (; i + 16 <= bytes; i += 16)
+        _mm_stream_si128(
+            reinterpret_cast<__m128i *>(dst + i),
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+    std::memcpy(dst + i, src + i, bytes - i);
+#else
+    std::memcpy(dst, src, bytes);
+#endif
+}
+
+void plainCopy(char *dst, const char *src, size_t bytes) {
+    std::memcpy(dst, src, bytes);
+}
+
+void storeFence() {
+#if defined(__SSE2__)
+    _mm_sfence();
+#endif
+}
+
+// One input seen as `nBlocks` contiguous runs of `run` bytes, which land
+// `dstStride` bytes apart in the output. A task copies `blocksPerTask` whole
+// runs, or one of the `piecesPerBlock` pieces of a run longer than a grain.
+struct Part {
+    const char *src;
+    char *dst;
+    size_t run, nBlocks, dstStride;
+    size_t blocksPerTask, piecesPerBlock;
+
+    size_t numTasks() const {
+        return (nBlocks + blocksPerTask - 1) / blocksPerTask * piecesPerBlock;
+    }
+};
+
+} // namespace
+
 class NaiveConcat : public CpuKernelWithoutConfig {
-    template <typename T>
-    void doCompute(const Operator &_op, const RuntimeObj *context) const {
+    Step prepare(const Operator &_op,
+                 const RuntimeObj *context) const override {
         auto op = as<ConcatObj>(_op);
-        auto inputs = op->getInputs(), outputs = op->getOutputs();
+        auto inputs = op->getInputs();
+        auto output = op->getOutput();
         auto dim = op->getDim();
-        auto output = outputs[0];
-        std::vector<Shape> iDims;
-        for (auto input : inputs)
-            iDims.emplace_back(input->getDims());
+        // Concat only moves elements, so it works on bytes of any type.
+        size_t elemSize = output->getDType().getSize();
         const auto &outDim = output->getDims();
-        size_t blockOffsetInner = 1;
-        for (size_t i = outDim.size() - 1; i > (size_t)dim; --i)
-            blockOffsetInner *= outDim[i];
-        size_t blockOffset = outDim[dim] * blockOffsetInner;
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            auto input = inputs[i];
-            auto dimOffset = 0;
-            auto iDim = iDims[i];
-            for (size_t j = 0; j < i; ++j)
-                dimOffset += iDims[j][dim];
-            size_t localBlockOffset = 1;
-            for (size_t i = iDim.size() - 1;
-                 i >= (size_t)dim && i != (size_t)-1; --i)
-                localBlockOffset *= iDim[i];
-            auto innerOffset = blockOffsetInner * dimOffset;
-            auto inSize = input->size();
-            auto inPtr = input->getRawDataPtr<T *>(),
-                 outPtr = output->getRawDataPtr<T *>();
-#pragma omp parallel for
-            for (size_t iOffset = 0; iOffset < inSize; ++iOffset) {
-                auto oOffset = iOffset % localBlockOffset + innerOffset +
-                               iOffset / localBlockOffset * blockOffset;
-                outPtr[oOffset] = inPtr[iOffset];
+        size_t inner = elemSize;
+        for (size_t i = dim + 1; i < outDim.size(); ++i)
+            inner *= outDim[i];
+        size_t dstStride = outDim[dim] * inner;
+        auto outPtr = output->getRawDataPtr<char *>();
+
+        vector<Part> parts;
+        // First task of every part, plus the total.
+        vector<size_t> firstTask{0};
+        size_t dimOffset = 0, copied = 0;
+        for (const auto &input : inputs) {
+            size_t run = input->getDims()[dim] * inner;
+            auto src = input->getRawDataPtr<const char *>();
+            auto dst = outPtr + dimOffset * inner;
+            dimOffset += input->getDims()[dim];
+            // Inputs the memory planner placed in their slice of the output
+            // are already in place.
+            if (run == 0 || (src == dst && input->getBytes() == run))
+                continue;
+            Part part{src, dst, run, input->getBytes() / run, dstStride, 1, 1};
+            // Along the outermost axis, or when the other inputs are empty,
+            // the runs of an input are adjacent in the output too.
+            if (part.dstStride == part.run) {
+                part.run *= part.nBlocks;
+                part.nBlocks = 1;
             }
+            if (part.run >= grain)
+                part.piecesPerBlock = (part.run + grain - 1) / grain;
+            else
+                part.blocksPerTask = grain / part.run;
+            copied += part.run * part.nBlocks;
+            parts.emplace_back(part);
+            firstTask.emplace_back(firstTask.back() + part.numTasks());
         }
+        bool stream = copied >= streamThreshold;
+        auto copy = stream ? streamCopy : plainCopy;
+
+        return [=] {
+            parallel_for(firstTask.back(), [&](size_t first, size_t last) {
+                size_t p = std::upper_bound(firstTask.begin(), firstTask.end(),
+                                            first) -
+                           firstTask.begin() - 1;
+                for (size_t task = first; task < last; ++task) {
+                    while (task >= firstTask[p + 1])
+                        ++p;
+                    const auto &part = parts[p];
+                    size_t local = task - firstTask[p];
+                    size_t chunk = local / part.piecesPerBlock;
+                    size_t piece = local % part.piecesPerBlock;
+                    size_t begin = piece * grain;
+                    size_t bytes = part.piecesPerBlock == 1
+                                       ? part.run
+                                       : std::min(grain, part.run - begin);
+                    size_t blockEnd = std::min(
+                        part.nBlocks, (chunk + 1) * part.blocksPerTask);
+                    for (size_t b = chunk * part.blocksPerTask; b < blockEnd;
+                         ++b)
+                        copy(part.dst + b * part.dstStride + begin,
+                             part.src + b * part.run + begin, bytes);
+                }
+                if (stream)
+                    storeFence();
+            });
+        };
     }
 
     void compute(const Operator &_op,
                  const RuntimeObj *context) const override {
-#define CASE(N)                                                                \
-    case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
-
-        int dataTypeIdx = _op->getDType().getIndex();
-        switch (dataTypeIdx) {
-            CASE(1); // DataType::Float32
-            break;
-            CASE(12); // DataType::UInt32
-            break;
-        default:
-            IT_TODO_HALT();
-        }
+        prepare(_op, context)();
     }
 };
 
@@ -1,115 +1,163 @@
 #include "operators/element_wise.h"
 #include "core/kernel.h"
-#include "utils/operator_utils.h"
+#include "kernels/cpu/simd.h"
+#include "utils/broadcast.h"
+#include "utils/thread_pool.h"
 
 namespace infini
 {
     class NativeElementWise : public CpuKernelWithoutConfig
     {
-        template <typename T>
-        static T addCompute(T val0, T val1)
-        {
-            return val0 + val1;
-        }
-
-        template <typename T>
-        static T subCompute(T val0, T val1)
-        {
-            return val0 - val1;
-        }
-
-        template <typename T>
-        static T mulCompute(T val0, T val1)
-        {
-            return val0 * val1;
-        }
+        // Elements handled per task when splitting work across threads.
+        static constexpr size_t grain = 1 << 14;
 
         template <typename T>
-        static T divCompute(T val0, T val1)
+        static typename SimdOps<T>::Binary pickKernel(const SimdOps<T> &ops,
+                                                      OpType type)
         {
-            return (T)(val0 / val1);
+            switch (type.underlying())
+            {
+            case OpType::Add:
+                return ops.add;
+            case OpType::Sub:
+                return ops.sub;
+            case OpType::Mul:
+                return ops.mul;
+            case OpType::Div:
+                return ops.div;
+            default:
+                IT_TODO_HALT();
+            }
         }
 
-        template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        // `kernel` computes one row of elements of type T with the steps of
+        // SimdOps<T>::Binary.
+        template <typename T, typename Kernel>
+        Step doPrepare(const Operator &_op, Kernel kernel) const
         {
             auto op = as<ElementWiseObj>(_op);
             T *inptr0 = op->getInputs(0)->getRawDataPtr<T *>();
             T *inptr1 = op->getInputs(1)->getRawDataPtr<T *>();
             T *outptr = op->getOutput()->getRawDataPtr<T *>();
 
-            auto shapeA = op->getInputs(0)->getDims();
-            auto shapeB = op->getInputs(1)->getDims();
-            auto shapeC = op->getOutput()->getDims();
-            auto rank = op->getOutput()->getRank();
-            Shape a(rank, 1);
-            Shape b(rank, 1);
-            std::copy(shapeA.begin(), shapeA.end(),
-                      a.begin() + (rank - shapeA.size()));
-            std::copy(shapeB.begin(), shapeB.end(),
-                      b.begin() + (rank - shapeB.size()));
-            auto getStride = [&](const Shape &shape)
+            BroadcastIterator it(op->getOutput()->getDims(),
+                                 {op->getInputs(0)->getDims(),
+                                  op->getInputs(1)->getDims()},
+                                 {op->getInputs(0)->getStrides(),
+                                  op->getInputs(1)->getStrides()});
+            if (it.isContiguous())
             {
-                int p = 1;
-                Shape stride(rank);
-                for (auto i = rank; i > 0; --i)
+                size_t n = it.size(), nTasks = (n + grain - 1) / grain;
+                return [=]
+                {
+                    parallel_for(nTasks, [&](size_t first, size_t last)
+                                 {
+                                     size_t begin = first * grain;
+                                     kernel(outptr + begin, inptr0 + begin, 1,
+                                            inptr1 + begin, 1,
+                                            std::min(last * grain, n) - begin);
+                                 });
+                };
+            }
+            size_t row = it.rowSize(), nRows = it.numRows();
+            size_t sa = it.innerStride(0), sb = it.innerStride(1);
+            size_t rowsPerTask = std::max<size_t>(1, grain / row);
+            size_t nTasks = (nRows + rowsPerTask - 1) / rowsPerTask;
+            if (sa <= 1 && sb <= 1)
+                return [=]
                 {
-                    stride[i - 1] = p;
-                    p = p * shape[i - 1];
-                }
-                return stride;
+                    parallel_for(
+                        nTasks, [&](size_t first, size_t last)
+                        {
+                            it.forEachRow(
+                                first * rowsPerTask,
+                                std::min(nRows, last * rowsPerTask),
+                                [&](size_t outOffset, const size_t *inOffsets)
+                                {
+                                    kernel(outptr + outOffset,
+                                           inptr0 + inOffsets[0], sa,
+                                           inptr1 + inOffsets[1], sb, row);
+                                });
+                        });
+                };
+            // A strided view input, e.g. a Transpose output, is gathered
+            // into a contiguous row first so the vector kernel still applies.
+            return [=]
+            {
+                parallel_for(
+                    nTasks, [&](size_t first, size_t last)
+                    {
+                        vector<T> rowA(sa > 1 ? row : 0), rowB(sb > 1 ? row : 0);
+                        auto gather = [&](vector<T> &buf, const T *in,
+                                          size_t stride)
+                        {
+                            for (size_t j = 0; j < row; ++j)
+                                buf[j] = in[j * stride];
+                            return buf.data();
+                        };
+                        it.forEachRow(
+                            first * rowsPerTask,
+                            std::min(nRows, last * rowsPerTask),
+                            [&](size_t outOffset, const size_t *inOffsets)
+                            {
+                                const T *a = inptr0 + inOffsets[0];
+                                const T *b = inptr1 + inOffsets[1];
+                                if (sa > 1)
+                                    a = gather(rowA, a, sa);
+                                if (sb > 1)
+                                    b = gather(rowB, b, sb);
+                                kernel(outptr + outOffset, a, sa > 1 ? 1 : sa,
+                                       b, sb > 1 ? 1 : sb, row);
+                            });
+                    });
             };
-            Shape strideA = getStride(a);
-            Shape strideB = getStride(b);
+        }
 
-            auto n = op->getOutput()->size();
-            T (*_doCompute)
-            (T val0, T val1);
-            switch (op->getOpType().underlying())
-            {
-            case OpType::Add:
-                _doCompute = addCompute<T>;
-                break;
-            case OpType::Sub:
-                _doCompute = subCompute<T>;
-                break;
-            case OpType::Mul:
-                _doCompute = mulCompute<T>;
-                break;
-            case OpType::Div:
-                _doCompute = divCompute<T>;
-                break;
-            default:
-                IT_TODO_HALT();
-            }
+        template <typename T>
+        Step doPrepare(const Operator &_op) const
+        {
+            auto kernel = pickKernel(get_simd_ops<T>(), _op->getOpType());
+            return doPrepare<T>(_op, kernel);
+        }
 
-            for (size_t i = 0; i < n; ++i)
-            {
-                auto shapeIndexC = locate_index(i, shapeC);
-                auto indexA = delocate_index(shapeIndexC, a, strideA);
-                auto indexB = delocate_index(shapeIndexC, b, strideB);
-                outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
-            }
+        // Half precision is stored as is and computed in float.
+        Step doPrepareHalf(const Operator &_op, HalfCast cast) const
+        {
+            auto kernel = pickKernel(get_simd_ops<float>(), _op->getOpType());
+            HalfRows rows{cast};
+            return doPrepare<uint16_t>(
+                _op, [=](uint16_t *out, const uint16_t *a, size_t sa,
+                         const uint16_t *b, size_t sb, size_t n)
+                { rows.binary(kernel, out, a, sa, b, sb, n); });
         }
 
-        void compute(const Operator &_op,
+        Step prepare(const Operator &_op,
                      const RuntimeObj *context) const override
         {
 #define CASE(N) \
     case N:     \
-        doCompute<DT<N>::t>(_op, context)
+        return doPrepare<DT<N>::t>(_op)
 
+            const auto &cast = get_simd_kernels().cast;
             int dataTypeIdx = _op->getDType().getIndex();
             switch (dataTypeIdx)
             {
                 CASE(1); // DataType::Float32
-                break;
                 CASE(12); // DataType::UInt32
-                break;
+            case 10: // DataType::Float16
+                return doPrepareHalf(_op, cast.f16());
+            case 16: // DataType::BFloat16
+                return doPrepareHalf(_op, cast.bf16());
             default:
                 IT_TODO_HALT();
             }
         }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            prepare(_op, context)();
+        }
     };
 
     REGISTER_KERNEL(Device::CPU, OpType::Add, NativeElementWise, "addNaive_CPU");
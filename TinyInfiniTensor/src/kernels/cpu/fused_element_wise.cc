@@ -0,0 +1,240 @@
+#include "operators/fused_element_wise.h"
+#include "core/kernel.h"
+#include "kernels/cpu/simd.h"
+#include "utils/broadcast.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace infini
+{
+    class FusedElementWiseCpu : public CpuKernelWithoutConfig
+    {
+        using Instruction = FusedElementWiseObj::Instruction;
+
+        // Elements handled per task when splitting work across threads.
+        static constexpr size_t grain = 1 << 14;
+        // Elements evaluated per instruction at a time. The tiles of all
+        // intermediate results of one thread stay in cache.
+        static constexpr size_t tile = 256;
+
+        // Elements of one slot over a tile, with an element stride of 0 or 1.
+        struct Operand
+        {
+            const void *ptr;
+            size_t stride;
+        };
+
+        // Clip bounds converted to the element type, missing bounds clip to
+        // the whole range of T.
+        template <typename T>
+        static std::pair<T, T> clipBounds(const Instruction &instr)
+        {
+            using limits = std::numeric_limits<T>;
+            auto bound = [](std::optional<float> value, T fallback)
+            {
+                if (!value)
+                    return fallback;
+                return T(std::clamp<double>(*value, limits::lowest(),
+                                            limits::max()));
+            };
+            return {bound(instr.min, limits::has_infinity ? -limits::infinity()
+                                                          : limits::lowest()),
+                    bound(instr.max, limits::has_infinity ? limits::infinity()
+                                                          : limits::max())};
+        }
+
+        template <typename T>
+        static void evalTyped(const Instruction &instr, T *dst, Operand a,
+                              Operand b, size_t n)
+        {
+            const auto &ops = get_simd_ops<T>();
+            auto pa = static_cast<const T *>(a.ptr);
+            auto pb = static_cast<const T *>(b.ptr);
+            switch (instr.type.underlying())
+            {
+            case OpType::Add:
+                return ops.add(dst, pa, a.stride, pb, b.stride, n);
+            case OpType::Sub:
+                return ops.sub(dst, pa, a.stride, pb, b.stride, n);
+            case OpType::Mul:
+                return ops.mul(dst, pa, a.stride, pb, b.stride, n);
+            case OpType::Div:
+                return ops.div(dst, pa, a.stride, pb, b.stride, n);
+            default:
+                break;
+            }
+            // Unary kernels read contiguous inputs; a broadcast operand is
+            // expanded into the destination first and processed in place.
+            if (a.stride == 0)
+            {
+                std::fill(dst, dst + n, pa[0]);
+                pa = dst;
+            }
+            if (instr.type == OpType::Relu)
+                return ops.relu(dst, pa, n);
+            if (instr.type == OpType::Clip)
+            {
+                auto [lo, hi] = clipBounds<T>(instr);
+                return ops.clip(dst, pa, n, lo, hi);
+            }
+            IT_TODO_HALT();
+        }
+
+        static void evalCast(const Instruction &instr, void *dst, Operand a,
+                             size_t n)
+        {
+            switch (instr.castType)
+            {
+            case CastType::Float2Int32:
+            {
+                auto src = static_cast<const float *>(a.ptr);
+                auto out = static_cast<int32_t *>(dst);
+                if (a.stride == 1)
+                    return get_simd_kernels().cast.f32ToI32(out, src, n);
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = float_to_int<int32_t>(src[i * a.stride]);
+                break;
+            }
+            case CastType::Int322Float:
+            {
+                auto src = static_cast<const int32_t *>(a.ptr);
+                auto out = static_cast<float *>(dst);
+                if (a.stride == 1)
+                    return get_simd_kernels().cast.i32ToF32(out, src, n);
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = float(src[i * a.stride]);
+                break;
+            }
+            case CastType::Float2Float:
+            {
+                auto src = static_cast<const float *>(a.ptr);
+                auto out = static_cast<float *>(dst);
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = src[i * a.stride];
+                break;
+            }
+            default:
+                IT_TODO_HALT();
+            }
+        }
+
+        static void eval(const Instruction &instr, void *dst, Operand a,
+                         Operand b, size_t n)
+        {
+            if (instr.type == OpType::Cast)
+                return evalCast(instr, dst, a, n);
+            if (instr.dtype == DataType::Float32)
+                return evalTyped(instr, static_cast<float *>(dst), a, b, n);
+            if (instr.dtype == DataType::UInt32)
+                return evalTyped(instr, static_cast<uint32_t *>(dst), a, b, n);
+            IT_TODO_HALT();
+        }
+
+        Step prepare(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<FusedElementWiseObj>(_op);
+            auto program = op->getProgram();
+            const auto &inputs = op->getInputs();
+            auto output = op->getOutput();
+            // Every slot holds 32-bit elements, see FusedElementWiseObj::isFusible.
+            constexpr size_t elemSize = 4;
+            for (const auto &input : inputs)
+                IT_ASSERT(input->getDType().getSize() == elemSize);
+            IT_ASSERT(output->getDType().getSize() == elemSize);
+
+            size_t nIn = inputs.size(), nInstr = program.size();
+            vector<const char *> inPtrs(nIn);
+            vector<Shape> inShapes(nIn);
+            for (size_t i = 0; i < nIn; ++i)
+            {
+                inPtrs[i] = inputs[i]->getRawDataPtr<char *>();
+                inShapes[i] = inputs[i]->getDims();
+            }
+            char *outPtr = output->getRawDataPtr<char *>();
+
+            BroadcastIterator it(output->getDims(), inShapes);
+            size_t row = it.rowSize(), nRows = it.numRows();
+            if (nRows == 0)
+                return [] {};
+            vector<size_t> strides(nIn);
+            for (size_t i = 0; i < nIn; ++i)
+                strides[i] = it.innerStride(i);
+
+            // Evaluates output elements [begin, begin + len) of one row.
+            auto evalSpan = [=](size_t outOffset, const size_t *inOffsets,
+                                size_t begin, size_t len, char *scratch,
+                                Operand *slots)
+            {
+                for (size_t t = begin; t < begin + len; t += tile)
+                {
+                    size_t n = std::min(tile, begin + len - t);
+                    for (size_t i = 0; i < nIn; ++i)
+                        slots[i] = {inPtrs[i] + (inOffsets[i] + t * strides[i]) *
+                                                    elemSize,
+                                    strides[i]};
+                    for (size_t k = 0; k < nInstr; ++k)
+                    {
+                        const auto &instr = program[k];
+                        void *dst = k + 1 == nInstr
+                                        ? outPtr + (outOffset + t) * elemSize
+                                        : scratch + k * tile * elemSize;
+                        Operand b = instr.b < 0 ? Operand{nullptr, 0}
+                                                : slots[instr.b];
+                        eval(instr, dst, slots[instr.a], b, n);
+                        slots[nIn + k] = {dst, 1};
+                    }
+                }
+            };
+
+            // Long rows are split into segments, short rows are grouped.
+            size_t segments = (row + grain - 1) / grain;
+            size_t rowsPerTask = std::max<size_t>(1, grain / row);
+            size_t nTasks = segments > 1
+                                ? nRows * segments
+                                : (nRows + rowsPerTask - 1) / rowsPerTask;
+            // Scratch tiles are set up once per chunk of tasks.
+            auto runTasks = [=](size_t first, size_t last)
+            {
+                vector<char> scratch(nInstr * tile * elemSize);
+                vector<Operand> slots(nIn + nInstr);
+                for (size_t task = first; task < last; ++task)
+                {
+                    size_t rowBegin, rowEnd, begin, len;
+                    if (segments > 1)
+                    {
+                        rowBegin = task / segments;
+                        rowEnd = rowBegin + 1;
+                        begin = task % segments * grain;
+                        len = std::min(grain, row - begin);
+                    }
+                    else
+                    {
+                        rowBegin = task * rowsPerTask;
+                        rowEnd = std::min(nRows, rowBegin + rowsPerTask);
+                        begin = 0;
+                        len = row;
+                    }
+                    it.forEachRow(rowBegin, rowEnd,
+                                  [&](size_t outOffset, const size_t *inOffsets)
+                                  {
+                                      evalSpan(outOffset, inOffsets, begin, len,
+                                               scratch.data(), slots.data());
+                                  });
+                }
+            };
+            return [=] { parallel_for(nTasks, runTasks); };
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            prepare(_op, context)();
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::FusedElementWise, FusedElementWiseCpu,
+                    "FusedElementWise_CPU");
+}; // namespace infini
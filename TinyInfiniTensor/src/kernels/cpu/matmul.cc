@@ -0,0 +1,350 @@
+#include "operators/matmul.h"
+#include "core/kernel.h"
+#include "kernels/cpu/simd.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+
+namespace infini {
+
+namespace {
+
+// Register tile of C computed by the micro-kernel. MR x NR accumulators are
+// kept small enough to stay in vector registers even without AVX.
+constexpr int MR = 4;
+constexpr int NR = 8;
+
+// Cache blocking: an MC x KC panel of A is sized for L2, a KC x NC panel of B
+// for L2/L3, and the KC x NR sliver of B streamed by the micro-kernel for L1.
+// The default suits mid-sized matrices; the kernel is tuned per shape among
+// the candidates below.
+struct GemmBlocking {
+    int mc = 64;
+    int kc = 256;
+    int nc = 512;
+};
+
+const GemmBlocking gemmCandidates[] = {
+    {64, 256, 512}, {32, 128, 256}, {16, 256, 128}, {128, 256, 1024},
+    {64, 512, 256},
+};
+
+// How elements stored as `Elem` are multiplied: operands are widened to
+// `Acc` while packing, products are accumulated in `Acc` and C is stored as
+// `Out`. Half precision formats accumulate in float and round the results
+// once; Int8 accumulates exactly in, and outputs, Int32.
+template <typename T> struct NativeFormat {
+    using Elem = T;
+    using Acc = T;
+    using Out = T;
+    static T widen(T v) { return v; }
+};
+
+struct Int8Format {
+    using Elem = int8_t;
+    using Acc = int32_t;
+    using Out = int32_t;
+    static int32_t widen(int8_t v) { return v; }
+};
+
+struct Float16Format {
+    using Elem = uint16_t;
+    using Acc = float;
+    using Out = uint16_t;
+    static float widen(uint16_t v) { return half_to_float(v); }
+    static HalfCast cast() { return get_simd_kernels().cast.f16(); }
+};
+
+struct BFloat16Format {
+    using Elem = uint16_t;
+    using Acc = float;
+    using Out = uint16_t;
+    static float widen(uint16_t v) { return bfloat16_to_float(v); }
+    static HalfCast cast() { return get_simd_kernels().cast.bf16(); }
+};
+
+// Whether the accumulators are stored to C directly.
+template <class F>
+constexpr bool storesAcc = std::is_same_v<typename F::Out, typename F::Acc>;
+
+// A view of a row-major matrix with arbitrary element strides, so that the
+// transposed operands are read in place instead of being materialized.
+template <typename T> struct MatrixRef {
+    const T *ptr;
+    size_t rowStride, colStride;
+    T at(size_t r, size_t c) const { return ptr[r * rowStride + c * colStride]; }
+};
+
+// Pack rows [0, mc) x cols [0, kc) of A into MR-row slivers, each laid out
+// k-major so the micro-kernel reads MR consecutive values per k step. Rows
+// past the edge are zero padded.
+template <class F, typename T = typename F::Acc>
+void packA(const MatrixRef<typename F::Elem> &a, int mc, int kc, T *packed) {
+    for (int ir = 0; ir < mc; ir += MR) {
+        int rows = std::min(MR, mc - ir);
+        for (int p = 0; p < kc; ++p) {
+            for (int r = 0; r < rows; ++r)
+                packed[r] = F::widen(a.at(ir + r, p));
+            for (int r = rows; r < MR; ++r)
+                packed[r] = T(0);
+            packed += MR;
+        }
+    }
+}
+
+// Pack rows [0, kc) x cols [0, nc) of B into NR-column slivers, each laid out
+// k-major with NR consecutive values per k step. Columns past the edge are
+// zero padded.
+template <class F, typename T = typename F::Acc>
+void packB(const MatrixRef<typename F::Elem> &b, int kc, int nc, T *packed) {
+    for (int jr = 0; jr < nc; jr += NR) {
+        int cols = std::min(NR, nc - jr);
+        for (int p = 0; p < kc; ++p) {
+            if (cols == NR && b.colStride == 1) {
+                const auto *src = b.ptr + p * b.rowStride + jr;
+                if constexpr (std::is_same_v<typename F::Elem, uint16_t>)
+                    F::cast().widen(packed, src, NR);
+                else
+                    for (int c = 0; c < NR; ++c)
+                        packed[c] = F::widen(src[c]);
+            } else {
+                for (int c = 0; c < cols; ++c)
+                    packed[c] = F::widen(b.at(p, jr + c));
+                for (int c = cols; c < NR; ++c)
+                    packed[c] = T(0);
+            }
+            packed += NR;
+        }
+    }
+}
+
+// C[0:rows, 0:cols] (+)= Ap * Bp over kc steps. The full MR x NR tile is
+// always computed on the zero-padded panels; only the valid part is stored.
+template <typename T>
+void microKernel(int kc, const T *ap, const T *bp, T *c, size_t ldc, int rows,
+                 int cols, bool accumulate) {
+    T acc[MR][NR] = {};
+    for (int p = 0; p < kc; ++p) {
+        for (int r = 0; r < MR; ++r) {
+            T av = ap[r];
+            for (int j = 0; j < NR; ++j)
+                acc[r][j] += av * bp[j];
+        }
+        ap += MR;
+        bp += NR;
+    }
+    for (int r = 0; r < rows; ++r) {
+        T *row = c + r * ldc;
+        if (accumulate)
+            for (int j = 0; j < cols; ++j)
+                row[j] += acc[r][j];
+        else
+            for (int j = 0; j < cols; ++j)
+                row[j] = acc[r][j];
+    }
+}
+
+// Computes the mc x nc block of C at (ic, jc) for one batch, walking the K
+// dimension in kc-deep panels. `c` points at the block itself. `bufA` and
+// `bufB` are caller-owned packing buffers large enough for one panel each.
+template <class F, typename T = typename F::Acc>
+void gemmBlock(const MatrixRef<typename F::Elem> &a,
+               const MatrixRef<typename F::Elem> &b, T *c, size_t ldc, int ic,
+               int jc, int mc, int nc, int k, const GemmBlocking &blk, T *bufA,
+               T *bufB) {
+    for (int pc = 0; pc < k; pc += blk.kc) {
+        int kc = std::min(blk.kc, k - pc);
+        MatrixRef<typename F::Elem> aBlk{
+            a.ptr + ic * a.rowStride + pc * a.colStride, a.rowStride,
+            a.colStride};
+        MatrixRef<typename F::Elem> bBlk{
+            b.ptr + pc * b.rowStride + jc * b.colStride, b.rowStride,
+            b.colStride};
+        packA<F>(aBlk, mc, kc, bufA);
+        packB<F>(bBlk, kc, nc, bufB);
+        for (int jr = 0; jr < nc; jr += NR) {
+            const T *bp = bufB + (jr / NR) * NR * kc;
+            for (int ir = 0; ir < mc; ir += MR) {
+                const T *ap = bufA + (ir / MR) * MR * kc;
+                microKernel(kc, ap, bp, c + ir * ldc + jr, ldc,
+                            std::min(MR, mc - ir), std::min(NR, nc - jr),
+                            pc != 0);
+            }
+        }
+    }
+}
+
+// Offsets of every output batch into the (possibly broadcast) batches of an
+// operand laid out with element `strides`. Leading batch dims missing from
+// the operand, or of extent 1, get stride 0.
+vector<size_t> batchOffsets(const Shape &outDims, const Shape &dims,
+                            const vector<size_t> &strides) {
+    int outBatchRank = outDims.size() - 2;
+    int batchRank = dims.size() - 2;
+    size_t nBatch = 1;
+    for (int i = 0; i < outBatchRank; ++i)
+        nBatch *= outDims[i];
+
+    vector<size_t> outStrides(outBatchRank, 0);
+    for (int i = outBatchRank - 1, j = batchRank - 1; j >= 0; --i, --j)
+        if (dims[j] != 1)
+            outStrides[i] = strides[j];
+
+    vector<size_t> offsets(nBatch, 0);
+    for (size_t b = 0; b < nBatch; ++b) {
+        size_t rest = b, offset = 0;
+        for (int i = outBatchRank - 1; i >= 0; --i) {
+            offset += rest % outDims[i] * outStrides[i];
+            rest /= outDims[i];
+        }
+        offsets[b] = offset;
+    }
+    return offsets;
+}
+
+} // namespace
+
+class MatmulCpu : public TunableKernel {
+    // M, N and K of the multiplication of an op.
+    static std::tuple<int, int, int> gemmSize(const Ref<MatmulObj> &op) {
+        const auto &dimA = op->getInputs(0)->getDims();
+        const auto &dimC = op->getOutput()->getDims();
+        int rankA = dimA.size(), rankC = dimC.size();
+        return {dimC[rankC - 2], dimC[rankC - 1],
+                op->getTransA() ? dimA[rankA - 2] : dimA[rankA - 1]};
+    }
+
+    template <class F>
+    Step doPrepare(const Operator &_op, const GemmBlocking &blk,
+                   const RuntimeObj *context) const {
+        using T = typename F::Elem;
+        using Acc = typename F::Acc;
+        using Out = typename F::Out;
+        auto op = as<MatmulObj>(_op);
+        auto A = op->getInputs(0), B = op->getInputs(1), C = op->getOutput();
+        const auto &dimA = A->getDims(), &dimB = B->getDims(),
+                   &dimC = C->getDims();
+        bool transA = op->getTransA(), transB = op->getTransB();
+        int rankA = dimA.size(), rankC = dimC.size();
+        int m = dimC[rankC - 2], n = dimC[rankC - 1];
+        int k = transA ? dimA[rankA - 2] : dimA[rankA - 1];
+
+        auto aPtr = A->getRawDataPtr<T *>(), bPtr = B->getRawDataPtr<T *>(),
+             cPtr = C->getRawDataPtr<Out *>();
+        const auto &strideA = A->getStrides(), &strideB = B->getStrides();
+        int rankB = dimB.size();
+        auto offsetsA = batchOffsets(dimC, dimA, strideA);
+        auto offsetsB = batchOffsets(dimC, dimB, strideB);
+        size_t nBatch = offsetsA.size();
+        if (k == 0) {
+            size_t size = C->size();
+            return [=] { std::fill(cPtr, cPtr + size, Out(0)); };
+        }
+
+        // A is M x K (or K x M when transposed), B is K x N (or N x K).
+        // Either may be a strided view, e.g. of a Transpose output.
+        size_t aRow = strideA[rankA - 2], aCol = strideA[rankA - 1];
+        size_t bRow = strideB[rankB - 2], bCol = strideB[rankB - 1];
+        if (transA)
+            std::swap(aRow, aCol);
+        if (transB)
+            std::swap(bRow, bCol);
+
+        int tilesM = (m + blk.mc - 1) / blk.mc;
+        int tilesN = (n + blk.nc - 1) / blk.nc;
+        size_t nTasks = nBatch * tilesM * tilesN;
+
+        // Packing buffers are allocated once per chunk of tiles. Narrow
+        // formats also accumulate a block of C in Acc before rounding it.
+        return [=] {
+            parallel_for(nTasks, [&](size_t first, size_t last) {
+                vector<Acc> bufA((size_t)(blk.mc + MR) * blk.kc);
+                vector<Acc> bufB((size_t)(blk.nc + NR) * blk.kc);
+                vector<Acc> bufC(storesAcc<F> ? 0 : (size_t)blk.mc * blk.nc);
+                for (size_t task = first; task < last; ++task) {
+                    size_t batch = task / (tilesM * tilesN);
+                    int tile = task % (tilesM * tilesN);
+                    int ic = tile / tilesN * blk.mc,
+                        jc = tile % tilesN * blk.nc;
+                    int mc = std::min(blk.mc, m - ic),
+                        nc = std::min(blk.nc, n - jc);
+                    MatrixRef<T> a{aPtr + offsetsA[batch], aRow, aCol};
+                    MatrixRef<T> b{bPtr + offsetsB[batch], bRow, bCol};
+                    Out *c = cPtr + batch * m * n + (size_t)ic * n + jc;
+                    if constexpr (storesAcc<F>) {
+                        gemmBlock<F>(a, b, c, n, ic, jc, mc, nc, k, blk,
+                                     bufA.data(), bufB.data());
+                    } else {
+                        gemmBlock<F>(a, b, bufC.data(), blk.nc, ic, jc, mc, nc,
+                                     k, blk, bufA.data(), bufB.data());
+                        auto narrow = F::cast().narrow;
+                        for (int r = 0; r < mc; ++r)
+                            narrow(c + (size_t)r * n,
+                                   bufC.data() + (size_t)r * blk.nc, nc);
+                    }
+                }
+            });
+        };
+    }
+
+    vector<TuneConfig> getTuneConfigs(const Operator &_op) const override {
+        // Blocks are clamped to the matrices, so that candidates which end up
+        // the same for small shapes are only tried once.
+        auto [m, n, k] = gemmSize(as<MatmulObj>(_op));
+        auto roundUp = [](int x, int r) { return (x + r - 1) / r * r; };
+        vector<TuneConfig> configs;
+        for (const auto &blk : gemmCandidates) {
+            TuneConfig config{std::min(blk.mc, roundUp(std::max(m, 1), MR)),
+                              std::min(blk.kc, std::max(k, 1)),
+                              std::min(blk.nc, roundUp(std::max(n, 1), NR))};
+            if (std::find(configs.begin(), configs.end(), config) ==
+                configs.end())
+                configs.emplace_back(config);
+        }
+        return configs;
+    }
+
+    string getTuneKey(const Operator &_op) const override {
+        auto op = as<MatmulObj>(_op);
+        return string("MatMul/") + op->getDType().toString() + "/A=" +
+               vecToString(op->getInputs(0)->getDims()) +
+               "/B=" + vecToString(op->getInputs(1)->getDims()) +
+               "/tA=" + std::to_string(op->getTransA()) +
+               "/tB=" + std::to_string(op->getTransB()) +
+               stridesKey("/sA=", op->getInputs(0)) +
+               stridesKey("/sB=", op->getInputs(1));
+    }
+
+    // Strided views are read in another order, so they are tuned apart.
+    static string stridesKey(const char *name, const Tensor &t) {
+        return t->isContiguous() ? "" : name + vecToString(t->getStrides());
+    }
+
+    Step prepare(const Operator &_op, const TuneConfig &config,
+                 const RuntimeObj *context) const override {
+        IT_ASSERT(config.size() == 3);
+        GemmBlocking blk{config[0], config[1], config[2]};
+#define CASE(N)                                                                \
+    case N:                                                                    \
+        return doPrepare<NativeFormat<DT<N>::t>>(_op, blk, context)
+
+        int dataTypeIdx = _op->getDType().getIndex();
+        switch (dataTypeIdx) {
+            CASE(1);  // DataType::Float32
+            CASE(12); // DataType::UInt32
+        case 3:       // DataType::Int8
+            return doPrepare<Int8Format>(_op, blk, context);
+        case 10:      // DataType::Float16
+            return doPrepare<Float16Format>(_op, blk, context);
+        case 16:      // DataType::BFloat16
+            return doPrepare<BFloat16Format>(_op, blk, context);
+        default:
+            IT_TODO_HALT();
+        }
+    }
+
+    using TunableKernel::prepare;
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::MatMul, MatmulCpu, "Matmul_CPU");
+
+} // namespace infini
@@ -0,0 +1,166 @@
+#include "operators/quantize_linear.h"
+#include "core/kernel.h"
+#include "kernels/cpu/simd.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace infini
+{
+    namespace
+    {
+        // Elements handled per task when splitting work across threads.
+        constexpr size_t grain = 1 << 14;
+
+        // Runs `f(begin, end, channel)` over [0, n) in parallel, split so
+        // that every call covers elements of a single channel. Channel c
+        // spans `inner` consecutive elements and repeats every
+        // `channels * inner` elements.
+        template <typename F>
+        void forEachChannelRun(size_t n, size_t channels, size_t inner,
+                               const F &f)
+        {
+            size_t nTasks = (n + grain - 1) / grain;
+            parallel_for(nTasks, [&](size_t first, size_t last)
+                         {
+                             size_t end = std::min(last * grain, n);
+                             for (size_t i = first * grain; i < end;)
+                             {
+                                 size_t run = i / inner;
+                                 size_t next =
+                                     std::min(end, (run + 1) * inner);
+                                 f(i, next, run % channels);
+                                 i = next;
+                             }
+                         });
+        }
+
+        // Channel count and channel run length of a tensor's parameters.
+        std::pair<size_t, size_t> channelLayout(const Tensor &tensor,
+                                                const QuantParams &params)
+        {
+            if (params.isPerTensor())
+                return {1, std::max<size_t>(1, tensor->size())};
+            const auto &dims = tensor->getDims();
+            size_t inner = 1;
+            for (size_t d = params.axis + 1; d < dims.size(); ++d)
+                inner *= dims[d];
+            return {size_t(dims[params.axis]), std::max<size_t>(1, inner)};
+        }
+    } // namespace
+
+    class NativeQuantizeLinear : public CpuKernelWithoutConfig
+    {
+        template <typename T>
+        Step doPrepare(const Operator &_op) const
+        {
+            auto op = as<QuantizeLinearObj>(_op);
+            auto inptr = op->getInputs(0)->getRawDataPtr<float *>();
+            auto outptr = op->getOutput()->getRawDataPtr<T *>();
+            auto params = op->getParams();
+            auto [channels, inner] = channelLayout(op->getOutput(), params);
+            size_t n = op->getOutput()->size();
+            return [=, channels = channels, inner = inner]
+            {
+                forEachChannelRun(
+                    n, channels, inner,
+                    [&](size_t begin, size_t end, size_t c)
+                    {
+                        float scale = params.scales[c];
+                        int zero = params.zeroPoints[c];
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            // Round half to even, then saturate; NaN maps
+                            // to the zero point. The zero point is added in
+                            // 64 bits, past the saturated int32 range.
+                            int64_t q = int64_t(float_to_int<int32_t>(
+                                            std::nearbyint(inptr[i] / scale))) +
+                                        zero;
+                            outptr[i] = T(std::clamp<int64_t>(
+                                q, std::numeric_limits<T>::min(),
+                                std::numeric_limits<T>::max()));
+                        }
+                    });
+            };
+        }
+
+        Step prepare(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+#define CASE(N) \
+    case N:     \
+        return doPrepare<DT<N>::t>(_op)
+
+            int dataTypeIdx = _op->getOutDType().getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(2); // DataType::UInt8
+                CASE(3); // DataType::Int8
+            default:
+                IT_TODO_HALT();
+            }
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            prepare(_op, context)();
+        }
+    };
+
+    class NativeDequantizeLinear : public CpuKernelWithoutConfig
+    {
+        template <typename T>
+        Step doPrepare(const Operator &_op) const
+        {
+            auto op = as<DequantizeLinearObj>(_op);
+            auto inptr = op->getInputs(0)->getRawDataPtr<T *>();
+            auto outptr = op->getOutput()->getRawDataPtr<float *>();
+            auto params = op->getParams();
+            auto [channels, inner] = channelLayout(op->getOutput(), params);
+            size_t n = op->getOutput()->size();
+            return [=, channels = channels, inner = inner]
+            {
+                forEachChannelRun(
+                    n, channels, inner,
+                    [&](size_t begin, size_t end, size_t c)
+                    {
+                        float scale = params.scales[c];
+                        int zero = params.zeroPoints[c];
+                        // Int32 inputs minus the zero point may leave the
+                        // int range; subtract in 64 bits.
+                        for (size_t i = begin; i < end; ++i)
+                            outptr[i] =
+                                float(int64_t(inptr[i]) - zero) * scale;
+                    });
+            };
+        }
+
+        Step prepare(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            int dataTypeIdx = _op->getDType().getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(2); // DataType::UInt8
+                CASE(3); // DataType::Int8
+                CASE(6); // DataType::Int32
+            default:
+                IT_TODO_HALT();
+            }
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            prepare(_op, context)();
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::QuantizeLinear, NativeQuantizeLinear,
+                    "QuantizeLinear_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::DequantizeLinear,
+                    NativeDequantizeLinear, "DequantizeLinear_CPU");
+
+}; // namespace infini
@@ -0,0 +1,91 @@
+#include "kernels/cpu/simd_impl.h"
+
+namespace infini {
+
+namespace {
+
+// One-lane "vectors": the portable fallback and the reference for the ISA
+// specific tables.
+template <typename Elem> struct ScalarTraits {
+    using T = Elem;
+    using V = Elem;
+    static constexpr size_t W = 1;
+    static V load(const T *p) { return *p; }
+    static void store(T *p, V v) { *p = v; }
+    static V set1(T v) { return v; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V div(V a, V b) { return (T)(a / b); }
+    static V max(V a, V b) { return a > b ? a : b; }
+    static V min(V a, V b) { return a < b ? a : b; }
+
+    static constexpr size_t TW = 1;
+    template <typename E>
+    static void transposeTile(const E *in, size_t, E *out, size_t) {
+        *out = *in;
+    }
+};
+
+struct ScalarCast {
+    static constexpr size_t W = 1;
+    static void f32ToI32(int32_t *out, const float *in) {
+        *out = float_to_int<int32_t>(*in);
+    }
+    static void i32ToF32(float *out, const int32_t *in) { *out = float(*in); }
+    static void f32ToF16(uint16_t *out, const float *in) {
+        *out = float_to_half(*in);
+    }
+    static void f16ToF32(float *out, const uint16_t *in) {
+        *out = half_to_float(*in);
+    }
+    static void f32ToBf16(uint16_t *out, const float *in) {
+        *out = float_to_bfloat16(*in);
+    }
+    static void bf16ToF32(float *out, const uint16_t *in) {
+        *out = bfloat16_to_float(*in);
+    }
+};
+
+} // namespace
+
+const SimdKernels &get_simd_kernels_scalar() {
+    static const SimdKernels kernels{
+        CpuIsa::Scalar,
+        simd_impl::make_ops<ScalarTraits<float>>(),
+        simd_impl::make_ops<ScalarTraits<uint32_t>>(),
+        simd_impl::transpose<ScalarTraits<uint32_t>>,
+        simd_impl::transpose<ScalarTraits<uint16_t>, uint16_t>,
+        simd_impl::make_cast_ops<ScalarCast>(),
+    };
+    return kernels;
+}
+
+const SimdKernels *get_simd_kernels(CpuIsa isa) {
+    if (isa > detect_cpu_isa())
+        return nullptr;
+    switch (isa) {
+    case CpuIsa::Scalar:
+        return &get_simd_kernels_scalar();
+    case CpuIsa::SSE41:
+        return get_simd_kernels_sse41();
+    case CpuIsa::AVX2:
+        return get_simd_kernels_avx2();
+    case CpuIsa::AVX512:
+        return get_simd_kernels_avx512();
+    }
+    return nullptr;
+}
+
+const SimdKernels &get_simd_kernels() {
+    static const SimdKernels &kernels = [] () -> const SimdKernels & {
+        // Fall back level by level in case the build lacks an ISA.
+        for (int isa = (int)detect_cpu_isa(); isa > 0; --isa)
+            if (auto k = get_simd_kernels((CpuIsa)isa))
+                return *k;
+        return get_simd_kernels_scalar();
+    }();
+    return kernels;
+}
+
+} // namespace infini
@@ -0,0 +1,147 @@
+#include "kernels/cpu/simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma,f16c")
+#include "kernels/cpu/simd_impl.h"
+
+namespace infini {
+
+namespace {
+
+struct F32x8 {
+    using T = float;
+    using V = __m256;
+    static constexpr size_t W = 8;
+    static V load(const T *p) { return _mm256_loadu_ps(p); }
+    static void store(T *p, V v) { _mm256_storeu_ps(p, v); }
+    static V set1(T v) { return _mm256_set1_ps(v); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+
+    static constexpr size_t TW = 8;
+    static void transposeTile(const uint32_t *in, size_t ldIn, uint32_t *out,
+                              size_t ldOut) {
+        auto src = reinterpret_cast<const float *>(in);
+        auto dst = reinterpret_cast<float *>(out);
+        __m256 r[8], t[8];
+        for (int i = 0; i < 8; ++i)
+            r[i] = _mm256_loadu_ps(src + i * ldIn);
+        for (int i = 0; i < 8; i += 2) {
+            t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+        }
+        for (int i = 0; i < 8; i += 4) {
+            r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            r[i + 1] =
+                _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            r[i + 2] =
+                _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            r[i + 3] =
+                _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+        for (int i = 0; i < 4; ++i) {
+            t[i] = _mm256_permute2f128_ps(r[i], r[i + 4], 0x20);
+            t[i + 4] = _mm256_permute2f128_ps(r[i], r[i + 4], 0x31);
+        }
+        for (int i = 0; i < 8; ++i)
+            _mm256_storeu_ps(dst + i * ldOut, t[i]);
+    }
+};
+
+struct U32x8 {
+    using T = uint32_t;
+    using V = __m256i;
+    static constexpr size_t W = 8;
+    static V load(const T *p) { return _mm256_loadu_si256((const V *)p); }
+    static void store(T *p, V v) { _mm256_storeu_si256((V *)p, v); }
+    static V set1(T v) { return _mm256_set1_epi32((int)v); }
+    static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+    static V mul(V a, V b) { return _mm256_mullo_epi32(a, b); }
+    static V max(V a, V b) { return _mm256_max_epu32(a, b); }
+    static V min(V a, V b) { return _mm256_min_epu32(a, b); }
+};
+
+struct Cast8 {
+    static constexpr size_t W = 8;
+    static void f32ToI32(int32_t *out, const float *in) {
+        __m256 v = _mm256_loadu_ps(in);
+        // Zero NaNs, then turn the 0x80000000 that cvtt returns for values
+        // of 2^31 and above into INT32_MAX.
+        v = _mm256_and_ps(v, _mm256_cmp_ps(v, v, _CMP_ORD_Q));
+        __m256i big = _mm256_castps_si256(
+            _mm256_cmp_ps(v, _mm256_set1_ps(0x1p31f), _CMP_GE_OQ));
+        __m256i r = _mm256_xor_si256(_mm256_cvttps_epi32(v), big);
+        _mm256_storeu_si256((__m256i *)out, r);
+    }
+    static void i32ToF32(float *out, const int32_t *in) {
+        _mm256_storeu_ps(out, _mm256_cvtepi32_ps(
+                                  _mm256_loadu_si256((const __m256i *)in)));
+    }
+    static void f32ToF16(uint16_t *out, const float *in) {
+        _mm_storeu_si128((__m128i *)out,
+                         _mm256_cvtps_ph(_mm256_loadu_ps(in),
+                                         _MM_FROUND_TO_NEAREST_INT));
+    }
+    static void f16ToF32(float *out, const uint16_t *in) {
+        _mm256_storeu_ps(
+            out, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)in)));
+    }
+    static void f32ToBf16(uint16_t *out, const float *in) {
+        __m256 v = _mm256_loadu_ps(in);
+        __m256i bits = _mm256_castps_si256(v);
+        // Round to nearest even on the dropped half; NaNs are quieted.
+        __m256i odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16),
+                                       _mm256_set1_epi32(1));
+        __m256i r = _mm256_srli_epi32(
+            _mm256_add_epi32(
+                _mm256_add_epi32(bits, _mm256_set1_epi32(0x7fff)), odd),
+            16);
+        __m256i nan = _mm256_or_si256(_mm256_srli_epi32(bits, 16),
+                                      _mm256_set1_epi32(0x40));
+        r = _mm256_blendv_epi8(
+            r, nan, _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q)));
+        // Packing works per 128-bit lane; gather both halves in the low one.
+        r = _mm256_permute4x64_epi64(_mm256_packus_epi32(r, r), 0x08);
+        _mm_storeu_si128((__m128i *)out, _mm256_castsi256_si128(r));
+    }
+    static void bf16ToF32(float *out, const uint16_t *in) {
+        __m256i h = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)in));
+        _mm256_storeu_ps(out, _mm256_castsi256_ps(_mm256_slli_epi32(h, 16)));
+    }
+};
+
+} // namespace
+
+const SimdKernels *get_simd_kernels_avx2() {
+    static const SimdKernels kernels = [] {
+        SimdKernels k{CpuIsa::AVX2, simd_impl::make_ops<F32x8>(),
+                      simd_impl::make_ops<U32x8, false>(),
+                      simd_impl::transpose<F32x8>,
+                      get_simd_kernels_sse41()->transpose16};
+        // No vector integer division; keep the scalar loop.
+        k.u32.div = get_simd_kernels_scalar().u32.div;
+        k.cast = simd_impl::make_cast_ops<Cast8>();
+        return k;
+    }();
+    return &kernels;
+}
+
+} // namespace infini
+
+#pragma GCC pop_options
+
+#else
+
+namespace infini {
+const SimdKernels *get_simd_kernels_avx2() { return nullptr; }
+} // namespace infini
+
+#endif
@@ -0,0 +1,76 @@
+#include "kernels/cpu/simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+// GCC 12 flags the deliberately undefined passthrough operand of the masked
+// AVX-512 builtins behind max/min as maybe-uninitialized.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include "kernels/cpu/simd_impl.h"
+
+namespace infini {
+
+namespace {
+
+struct F32x16 {
+    using T = float;
+    using V = __m512;
+    static constexpr size_t W = 16;
+    static V load(const T *p) { return _mm512_loadu_ps(p); }
+    static void store(T *p, V v) { _mm512_storeu_ps(p, v); }
+    static V set1(T v) { return _mm512_set1_ps(v); }
+    static V add(V a, V b) { return _mm512_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm512_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm512_div_ps(a, b); }
+    static V max(V a, V b) { return _mm512_max_ps(a, b); }
+    static V min(V a, V b) { return _mm512_min_ps(a, b); }
+};
+
+struct U32x16 {
+    using T = uint32_t;
+    using V = __m512i;
+    static constexpr size_t W = 16;
+    static V load(const T *p) { return _mm512_loadu_si512(p); }
+    static void store(T *p, V v) { _mm512_storeu_si512(p, v); }
+    static V set1(T v) { return _mm512_set1_epi32((int)v); }
+    static V add(V a, V b) { return _mm512_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm512_sub_epi32(a, b); }
+    static V mul(V a, V b) { return _mm512_mullo_epi32(a, b); }
+    static V max(V a, V b) { return _mm512_max_epu32(a, b); }
+    static V min(V a, V b) { return _mm512_min_epu32(a, b); }
+};
+
+} // namespace
+
+const SimdKernels *get_simd_kernels_avx512() {
+    static const SimdKernels kernels = [] {
+        // AVX-512F implies AVX2; transposes reuse its 8x8 register tile.
+        SimdKernels k{CpuIsa::AVX512, simd_impl::make_ops<F32x16>(),
+                      simd_impl::make_ops<U32x16, false>(),
+                      get_simd_kernels_avx2()->transpose32,
+                      get_simd_kernels_sse41()->transpose16};
+        // No vector integer division; keep the scalar loop.
+        k.u32.div = get_simd_kernels_scalar().u32.div;
+        // Conversions are bound by memory at 8 lanes already.
+        k.cast = get_simd_kernels_avx2()->cast;
+        return k;
+    }();
+    return &kernels;
+}
+
+} // namespace infini
+
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+#else
+
+namespace infini {
+const SimdKernels *get_simd_kernels_avx512() { return nullptr; }
+} // namespace infini
+
+#endif
@@ -0,0 +1,151 @@
+#include "kernels/cpu/simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+#include "kernels/cpu/simd_impl.h"
+
+namespace infini {
+
+namespace {
+
+struct F32x4 {
+    using T = float;
+    using V = __m128;
+    static constexpr size_t W = 4;
+    static V load(const T *p) { return _mm_loadu_ps(p); }
+    static void store(T *p, V v) { _mm_storeu_ps(p, v); }
+    static V set1(T v) { return _mm_set1_ps(v); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm_div_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+
+    static constexpr size_t TW = 4;
+    static void transposeTile(const uint32_t *in, size_t ldIn, uint32_t *out,
+                              size_t ldOut) {
+        auto src = reinterpret_cast<const float *>(in);
+        auto dst = reinterpret_cast<float *>(out);
+        V r0 = load(src), r1 = load(src + ldIn), r2 = load(src + 2 * ldIn),
+          r3 = load(src + 3 * ldIn);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        store(dst, r0);
+        store(dst + ldOut, r1);
+        store(dst + 2 * ldOut, r2);
+        store(dst + 3 * ldOut, r3);
+    }
+};
+
+struct U32x4 {
+    using T = uint32_t;
+    using V = __m128i;
+    static constexpr size_t W = 4;
+    static V load(const T *p) { return _mm_loadu_si128((const V *)p); }
+    static void store(T *p, V v) { _mm_storeu_si128((V *)p, v); }
+    static V set1(T v) { return _mm_set1_epi32((int)v); }
+    static V add(V a, V b) { return _mm_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm_sub_epi32(a, b); }
+    static V mul(V a, V b) { return _mm_mullo_epi32(a, b); }
+    static V max(V a, V b) { return _mm_max_epu32(a, b); }
+    static V min(V a, V b) { return _mm_min_epu32(a, b); }
+};
+
+// 8 x 8 tiles of 16-bit elements, transposed by interleaving 16-, 32- and
+// 64-bit halves of row pairs.
+struct U16Tile8 {
+    static constexpr size_t TW = 8;
+    static void transposeTile(const uint16_t *in, size_t ldIn, uint16_t *out,
+                              size_t ldOut) {
+        __m128i r[8], t[8];
+        for (int i = 0; i < 8; ++i)
+            r[i] = _mm_loadu_si128((const __m128i *)(in + i * ldIn));
+        for (int i = 0; i < 4; ++i) {
+            t[i] = _mm_unpacklo_epi16(r[2 * i], r[2 * i + 1]);
+            t[i + 4] = _mm_unpackhi_epi16(r[2 * i], r[2 * i + 1]);
+        }
+        for (int i = 0; i < 8; i += 4) {
+            r[i] = _mm_unpacklo_epi32(t[i], t[i + 1]);
+            r[i + 1] = _mm_unpackhi_epi32(t[i], t[i + 1]);
+            r[i + 2] = _mm_unpacklo_epi32(t[i + 2], t[i + 3]);
+            r[i + 3] = _mm_unpackhi_epi32(t[i + 2], t[i + 3]);
+        }
+        for (int i = 0; i < 8; i += 4) {
+            t[i] = _mm_unpacklo_epi64(r[i], r[i + 2]);
+            t[i + 1] = _mm_unpackhi_epi64(r[i], r[i + 2]);
+            t[i + 2] = _mm_unpacklo_epi64(r[i + 1], r[i + 3]);
+            t[i + 3] = _mm_unpackhi_epi64(r[i + 1], r[i + 3]);
+        }
+        for (int i = 0; i < 8; ++i)
+            _mm_storeu_si128((__m128i *)(out + i * ldOut), t[i]);
+    }
+};
+
+// Half precision needs F16C; SSE4.1 only vectorizes the other casts.
+struct Cast4 {
+    static constexpr size_t W = 4;
+    static void f32ToI32(int32_t *out, const float *in) {
+        __m128 v = _mm_loadu_ps(in);
+        // Zero NaNs, then turn the 0x80000000 that cvtt returns for values
+        // of 2^31 and above into INT32_MAX.
+        v = _mm_and_ps(v, _mm_cmpord_ps(v, v));
+        __m128i big = _mm_castps_si128(_mm_cmpge_ps(v, _mm_set1_ps(0x1p31f)));
+        __m128i r = _mm_xor_si128(_mm_cvttps_epi32(v), big);
+        _mm_storeu_si128((__m128i *)out, r);
+    }
+    static void i32ToF32(float *out, const int32_t *in) {
+        _mm_storeu_ps(out,
+                      _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)in)));
+    }
+    static void f32ToBf16(uint16_t *out, const float *in) {
+        __m128 v = _mm_loadu_ps(in);
+        __m128i bits = _mm_castps_si128(v);
+        // Round to nearest even on the dropped half; NaNs are quieted.
+        __m128i odd =
+            _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1));
+        __m128i r = _mm_srli_epi32(
+            _mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(0x7fff)), odd),
+            16);
+        __m128i nan = _mm_or_si128(_mm_srli_epi32(bits, 16),
+                                   _mm_set1_epi32(0x40));
+        r = _mm_blendv_epi8(r, nan, _mm_castps_si128(_mm_cmpunord_ps(v, v)));
+        _mm_storel_epi64((__m128i *)out, _mm_packus_epi32(r, r));
+    }
+    static void bf16ToF32(float *out, const uint16_t *in) {
+        __m128i h = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)in));
+        _mm_storeu_ps(out, _mm_castsi128_ps(_mm_slli_epi32(h, 16)));
+    }
+};
+
+} // namespace
+
+const SimdKernels *get_simd_kernels_sse41() {
+    static const SimdKernels kernels = [] {
+        SimdKernels k{CpuIsa::SSE41, simd_impl::make_ops<F32x4>(),
+                      simd_impl::make_ops<U32x4, false>(),
+                      simd_impl::transpose<F32x4>,
+                      simd_impl::transpose<U16Tile8, uint16_t>};
+        // No vector integer division; keep the scalar loop.
+        k.u32.div = get_simd_kernels_scalar().u32.div;
+        k.cast = simd_impl::make_cast_ops<Cast4, false>();
+        k.cast.f32ToF16 = get_simd_kernels_scalar().cast.f32ToF16;
+        k.cast.f16ToF32 = get_simd_kernels_scalar().cast.f16ToF32;
+        return k;
+    }();
+    return &kernels;
+}
+
+} // namespace infini
+
+#pragma GCC pop_options
+
+#else
+
+namespace infini {
+const SimdKernels *get_simd_kernels_sse41() { return nullptr; }
+} // namespace infini
+
+#endif
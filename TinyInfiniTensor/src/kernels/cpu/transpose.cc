@@ -1,60 +1,247 @@
 #include "operators/transpose.h"
 #include "core/kernel.h"
+#include "kernels/cpu/simd.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cstring>
 
 namespace infini {
 
-inline Shape idx2Pos(const Shape &shape, size_t idx) {
-    Shape pos = Shape(shape.size(), 0);
-    auto rest = idx, curDimId = shape.size() - 1;
-    while (rest > 0) {
-        pos[curDimId] = rest % shape[curDimId];
-        rest /= shape[curDimId];
-        curDimId--;
+namespace {
+
+// Rows of the output (or of a 2-D tile) handled per task. The default suits
+// mid-sized tensors; the kernel is tuned per shape among the candidates.
+constexpr int rowBlockCandidates[] = {64, 16, 256};
+// Tensors at most this large always use the default.
+constexpr size_t tuneThreshold = 1 << 14;
+
+// A transpose reduced to its essential dimensions: extents of 1 are dropped
+// and input dimensions which stay adjacent and in order in the output are
+// merged. An identity permutation reduces to at most one dimension.
+struct ReducedTranspose {
+    Shape dims;       // input extents
+    vector<int> perm; // output dim j reads input dim perm[j]
+    size_t total;     // number of elements
+    // Element strides of input dim d in the input and in the output.
+    vector<size_t> inStride, outStrideOf;
+};
+
+ReducedTranspose reduceTranspose(const Shape &inDim, const vector<int> &perm) {
+    int rank = inDim.size();
+    vector<int> squeezed(rank, -1);
+    int kept = 0;
+    for (int d = 0; d < rank; ++d)
+        if (inDim[d] != 1)
+            squeezed[d] = kept++;
+    vector<int> order; // squeezed input dims in output order
+    for (int j = 0; j < rank; ++j)
+        if (squeezed[perm[j]] >= 0)
+            order.emplace_back(squeezed[perm[j]]);
+    Shape extents;
+    for (int d = 0; d < rank; ++d)
+        if (inDim[d] != 1)
+            extents.emplace_back(inDim[d]);
+
+    // Groups of consecutive input dims, in output order.
+    vector<std::pair<int, int>> groups; // [first, last] input dim
+    for (auto d : order) {
+        if (!groups.empty() && groups.back().second + 1 == d)
+            groups.back().second = d;
+        else
+            groups.emplace_back(d, d);
+    }
+    vector<int> byInput(groups.size());
+    for (size_t g = 0; g < groups.size(); ++g)
+        byInput[g] = g;
+    std::sort(byInput.begin(), byInput.end(), [&](int a, int b) {
+        return groups[a].first < groups[b].first;
+    });
+
+    ReducedTranspose ret;
+    ret.perm.resize(groups.size());
+    for (size_t i = 0; i < byInput.size(); ++i) {
+        auto [first, last] = groups[byInput[i]];
+        int extent = 1;
+        for (int d = first; d <= last; ++d)
+            extent *= extents[d];
+        ret.dims.emplace_back(extent);
+        ret.perm[byInput[i]] = i;
+    }
+
+    int reducedRank = ret.dims.size();
+    ret.total = 1;
+    for (auto d : inDim)
+        ret.total *= d;
+    vector<size_t> outStride(reducedRank);
+    ret.inStride.resize(reducedRank);
+    ret.outStrideOf.resize(reducedRank);
+    if (reducedRank > 0) {
+        ret.inStride[reducedRank - 1] = outStride[reducedRank - 1] = 1;
+        for (int d = reducedRank - 1; d > 0; --d) {
+            ret.inStride[d - 1] = ret.inStride[d] * ret.dims[d];
+            outStride[d - 1] = outStride[d] * ret.dims[ret.perm[d]];
+        }
+        for (int j = 0; j < reducedRank; ++j)
+            ret.outStrideOf[ret.perm[j]] = outStride[j];
+    }
+    return ret;
+}
+
+// out[j * ldOut + i] = in[i * ldIn + j] for i < rows, j < cols.
+template <typename T>
+void transpose2D(const T *in, size_t ldIn, T *out, size_t ldOut, size_t rows,
+                 size_t cols) {
+    if constexpr (sizeof(T) == sizeof(uint32_t)) {
+        get_simd_kernels().transpose32(
+            reinterpret_cast<const uint32_t *>(in), ldIn,
+            reinterpret_cast<uint32_t *>(out), ldOut, rows, cols);
+    } else if constexpr (sizeof(T) == sizeof(uint16_t)) {
+        get_simd_kernels().transpose16(
+            reinterpret_cast<const uint16_t *>(in), ldIn,
+            reinterpret_cast<uint16_t *>(out), ldOut, rows, cols);
+    } else {
+        constexpr size_t tile = 8;
+        for (size_t ib = 0; ib < rows; ib += tile)
+            for (size_t jb = 0; jb < cols; jb += tile)
+                for (size_t i = ib; i < std::min(ib + tile, rows); ++i)
+                    for (size_t j = jb; j < std::min(jb + tile, cols); ++j)
+                        out[j * ldOut + i] = in[i * ldIn + j];
+    }
+}
+
+template <typename T>
+void transposeReduced(const T *in, T *out, const ReducedTranspose &t,
+                      size_t rowBlock) {
+    const auto &dims = t.dims;
+    const auto &perm = t.perm;
+    const auto &inStride = t.inStride, &outStrideOf = t.outStrideOf;
+    int rank = dims.size();
+    size_t total = t.total;
+    if (total == 0)
+        return;
+    if (rank <= 1) {
+        std::memcpy(out, in, total * sizeof(T));
+        return;
     }
-    return pos;
+
+    if (perm[rank - 1] == rank - 1) {
+        // The innermost dim stays innermost: copy contiguous rows, walking
+        // the outer output dims with incremental input offsets.
+        size_t row = dims[rank - 1], nRows = total / row;
+        size_t nTasks = (nRows + rowBlock - 1) / rowBlock;
+        parallel_for(nTasks, [&](size_t first, size_t last) {
+            size_t begin = first * rowBlock,
+                   end = std::min(nRows, last * rowBlock);
+            vector<size_t> idx(rank - 1);
+            size_t inOffset = 0;
+            for (size_t rest = begin, j = rank - 1; j-- > 0;) {
+                idx[j] = rest % dims[perm[j]];
+                rest /= dims[perm[j]];
+                inOffset += idx[j] * inStride[perm[j]];
+            }
+            for (size_t r = begin; r < end; ++r) {
+                std::memcpy(out + r * row, in + inOffset, row * sizeof(T));
+                for (size_t j = rank - 1; j-- > 0;) {
+                    inOffset += inStride[perm[j]];
+                    if (++idx[j] < (size_t)dims[perm[j]])
+                        break;
+                    inOffset -= dims[perm[j]] * inStride[perm[j]];
+                    idx[j] = 0;
+                }
+            }
+        });
+        return;
+    }
+
+    // Otherwise every slice spanned by the input's innermost dim and the
+    // input dim that becomes the output's innermost is a strided 2-D
+    // transpose. Remaining dims form the batch of such slices.
+    int p = perm[rank - 1], c = rank - 1;
+    size_t rows = dims[p], cols = dims[c];
+    size_t ldIn = inStride[p], ldOut = outStrideOf[c];
+    vector<int> batchDims;
+    for (int d = 0; d < rank; ++d)
+        if (d != p && d != c)
+            batchDims.emplace_back(d);
+    size_t nBatch = total / (rows * cols);
+    size_t blocksPerSlice = (rows + rowBlock - 1) / rowBlock;
+    size_t nTasks = nBatch * blocksPerSlice;
+    parallel_for(nTasks, [&](size_t first, size_t last) {
+        for (size_t task = first; task < last; ++task) {
+            size_t batch = task / blocksPerSlice;
+            size_t rowBegin = task % blocksPerSlice * rowBlock;
+            size_t inOffset = rowBegin * ldIn, outOffset = rowBegin;
+            for (size_t rest = batch, i = batchDims.size(); i-- > 0;) {
+                int d = batchDims[i];
+                inOffset += rest % dims[d] * inStride[d];
+                outOffset += rest % dims[d] * outStrideOf[d];
+                rest /= dims[d];
+            }
+            transpose2D(in + inOffset, ldIn, out + outOffset, ldOut,
+                        std::min(rowBlock, rows - rowBegin), cols);
+        }
+    });
 }
 
-class NaiveTranspose : public CpuKernelWithoutConfig {
+} // namespace
+
+class TransposeCpu : public TunableKernel {
     template <typename T>
-    void doCompute(const Operator &_op, const RuntimeObj *context) const {
+    Step doPrepare(const Operator &_op, size_t rowBlock,
+                   const RuntimeObj *context) const {
         auto op = as<TransposeObj>(_op);
         auto inputs = op->getInputs(), outputs = op->getOutputs();
-        const auto &inDim = inputs[0]->getDims();
-        const auto &perm = op->getPermute();
-
-        size_t inSize = inputs[0]->size();
-        auto inPtr = inputs[0]->getRawDataPtr<T *>(),
-             outPtr = outputs[0]->getRawDataPtr<T *>();
-        // #pragma omp parallel for
-        for (size_t inIdx = 0; inIdx < inSize; ++inIdx) {
-            auto posInput = idx2Pos(inDim, inIdx);
-            int outIdx = 0;
-            for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
-                outIdx = outIdx * inDim[perm[j]] + posInput[perm[j]];
-            }
-            outPtr[outIdx] = inPtr[inIdx];
-        }
+        auto in = inputs[0]->getRawDataPtr<T *>();
+        auto out = outputs[0]->getRawDataPtr<T *>();
+        // The output is a strided view of the input; nothing to move.
+        if (in == out)
+            return [] {};
+        auto reduced = reduceTranspose(inputs[0]->getDims(), op->getPermute());
+        return [=] { transposeReduced(in, out, reduced, rowBlock); };
+    }
+
+    vector<TuneConfig> getTuneConfigs(const Operator &_op) const override {
+        // Nothing to tune for small inputs or for a view of the input.
+        if (_op->getInputs(0)->size() <= tuneThreshold ||
+            _op->getInputs(0)->getRawDataPtr<void *>() ==
+                _op->getOutput()->getRawDataPtr<void *>())
+            return {{rowBlockCandidates[0]}};
+        vector<TuneConfig> configs;
+        for (auto rowBlock : rowBlockCandidates)
+            configs.push_back({rowBlock});
+        return configs;
     }
 
-    void compute(const Operator &_op,
+    string getTuneKey(const Operator &_op) const override {
+        auto op = as<TransposeObj>(_op);
+        return "Transpose/" + std::to_string(op->getDType().getSize()) +
+               "/in=" + vecToString(op->getInputs(0)->getDims()) +
+               "/perm=" + vecToString(op->getPermute());
+    }
+
+    Step prepare(const Operator &_op, const TuneConfig &config,
                  const RuntimeObj *context) const override {
-#define CASE(N)                                                                \
-    case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
-
-        int dataTypeIdx = _op->getDType().getIndex();
-        switch (dataTypeIdx) {
-            CASE(1); // DataType::Float32
-            break;
-            CASE(12); // DataType::UInt32
-            break;
+        IT_ASSERT(config.size() == 1 && config[0] > 0);
+        size_t rowBlock = config[0];
+        // Transposes only move elements, so dispatch on the element size.
+        switch (_op->getDType().getSize()) {
+        case 1:
+            return doPrepare<uint8_t>(_op, rowBlock, context);
+        case 2:
+            return doPrepare<uint16_t>(_op, rowBlock, context);
+        case 4:
+            return doPrepare<uint32_t>(_op, rowBlock, context);
+        case 8:
+            return doPrepare<uint64_t>(_op, rowBlock, context);
         default:
             IT_TODO_HALT();
         }
     }
+
+    using TunableKernel::prepare;
 };
 
-REGISTER_KERNEL(Device::CPU, OpType::Transpose, NaiveTranspose,
-                "TransposeNaive_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::Transpose, TransposeCpu,
+                "Transpose_CPU");
 
 } // namespace infini
@@ -1,102 +1,202 @@
 #include "operators/unary.h"
 #include "core/kernel.h"
+#include "kernels/cpu/simd.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <limits>
 
 namespace infini
 {
+    // Elements handled per task when splitting work across threads.
+    static constexpr size_t grain = 1 << 14;
+
     class NativeUnary : public CpuKernelWithoutConfig
     {
         template <typename T>
-        static T reluCompute(T val)
+        static typename SimdOps<T>::Unary pickKernel(const SimdOps<T> &ops,
+                                                     OpType type)
         {
-            return std::max(T(0), val);
+            switch (type.underlying())
+            {
+            case OpType::Relu:
+                return ops.relu;
+            default:
+                IT_TODO_HALT();
+            }
         }
 
-        template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        // `kernel(out, in, n)` computes n contiguous elements of type T.
+        template <typename T, typename Kernel>
+        Step doPrepare(const Operator &_op, Kernel kernel) const
         {
             auto op = as<UnaryObj>(_op);
             T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
             T *outptr = op->getOutput()->getRawDataPtr<T *>();
 
-            auto outDim = op->getOutput()->getDims();
             auto n = op->getOutput()->size();
-
-            T (*_doCompute)
-            (T val);
-            switch (op->getOpType().underlying())
+            size_t nTasks = (n + grain - 1) / grain;
+            return [=]
             {
-            case OpType::Relu:
-                _doCompute = reluCompute<T>;
-                break;
-            default:
-                IT_TODO_HALT();
-            }
+                parallel_for(nTasks, [&](size_t first, size_t last)
+                             {
+                                 size_t begin = first * grain;
+                                 kernel(outptr + begin, inptr + begin,
+                                        std::min(last * grain, n) - begin);
+                             });
+            };
+        }
 
-            for (size_t offset = 0; offset < n; offset++)
-            {
-                outptr[offset] = _doCompute(inptr[offset]);
-            }
+        template <typename T>
+        Step doPrepare(const Operator &_op) const
+        {
+            auto kernel = pickKernel(get_simd_ops<T>(), _op->getOpType());
+            return doPrepare<T>(_op, kernel);
         }
 
-        void compute(const Operator &_op,
+        // Half precision is stored as is and computed in float.
+        Step doPrepareHalf(const Operator &_op, HalfCast cast) const
+        {
+            auto kernel = pickKernel(get_simd_ops<float>(), _op->getOpType());
+            HalfRows rows{cast};
+            return doPrepare<uint16_t>(
+                _op, [=](uint16_t *out, const uint16_t *in, size_t n)
+                { rows.unary(out, in, n, kernel); });
+        }
+
+        Step prepare(const Operator &_op,
                      const RuntimeObj *context) const override
         {
 #define CASE(N) \
     case N:     \
-        doCompute<DT<N>::t>(_op, context)
+        return doPrepare<DT<N>::t>(_op)
 
+            const auto &cast = get_simd_kernels().cast;
             int dataTypeIdx = _op->getDType().getIndex();
             switch (dataTypeIdx)
             {
                 CASE(1); // DataType::Float32
-                break;
                 CASE(12); // DataType::UInt32
-                break;
+            case 10: // DataType::Float16
+                return doPrepareHalf(_op, cast.f16());
+            case 16: // DataType::BFloat16
+                return doPrepareHalf(_op, cast.bf16());
             default:
                 IT_TODO_HALT();
             }
         }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            prepare(_op, context)();
+        }
     };
 
     class Clip : public CpuKernelWithoutConfig
     {
+        // Bounds of the op in the compute type T. Missing bounds clip to the
+        // whole range of T, so that infinities pass through for floating
+        // point types.
         template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        static std::pair<T, T> bounds(const Ref<ClipObj> &op)
         {
-            auto op = as<ClipObj>(_op);
-            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
-            T *outptr = op->getOutput()->getRawDataPtr<T *>();
-            auto minValue = op->getMin();
-            auto maxValue = op->getMax();
+            using limits = std::numeric_limits<T>;
+            auto bound = [](std::optional<float> value, T fallback)
+            {
+                if (!value)
+                    return fallback;
+                return T(std::clamp<double>(*value, limits::lowest(),
+                                            limits::max()));
+            };
+            return {bound(op->getMin(), limits::has_infinity
+                                            ? -limits::infinity()
+                                            : limits::lowest()),
+                    bound(op->getMax(), limits::has_infinity
+                                            ? limits::infinity()
+                                            : limits::max())};
+        }
 
-            auto n = op->getOutput()->size();
-            for (size_t offset = 0; offset < n; offset++)
+        // `kernel(out, in, n)` computes n contiguous elements of type T.
+        template <typename T, typename Kernel>
+        Step doPrepare(const Operator &_op, Kernel kernel) const
+        {
+            T *inptr = _op->getInputs(0)->getRawDataPtr<T *>();
+            T *outptr = _op->getOutput()->getRawDataPtr<T *>();
+            auto n = _op->getOutput()->size();
+            size_t nTasks = (n + grain - 1) / grain;
+            return [=]
+            {
+                parallel_for(nTasks, [&](size_t first, size_t last)
+                             {
+                                 size_t begin = first * grain;
+                                 kernel(outptr + begin, inptr + begin,
+                                        std::min(last * grain, n) - begin);
+                             });
+            };
+        }
+
+        template <typename T>
+        Step doPrepare(const Operator &_op) const
+        {
+            auto [lo, hi] = bounds<T>(as<ClipObj>(_op));
+            if constexpr (has_simd_ops<T>::value)
+            {
+                auto clip = get_simd_ops<T>().clip;
+                return doPrepare<T>(_op, [=](T *out, const T *in, size_t n)
+                                    { clip(out, in, n, lo, hi); });
+            }
+            else
             {
-                auto val = *inptr++;
-                *outptr++ = (minValue && val < *minValue)   ? *minValue
-                            : (maxValue && val > *maxValue) ? *maxValue
-                                                            : val;
+                // Quantized values, simple enough to auto-vectorize.
+                return doPrepare<T>(_op, [=](T *out, const T *in, size_t n)
+                                    {
+                                        for (size_t i = 0; i < n; ++i)
+                                            out[i] = std::clamp(in[i], lo, hi);
+                                    });
             }
         }
 
-        void compute(const Operator &_op,
-                     const RuntimeObj *context) const override
+        // Half precision is stored as is and clipped in float.
+        Step doPrepareHalf(const Operator &_op, HalfCast cast) const
         {
-#define CASE(N) \
-    case N:     \
-        doCompute<DT<N>::t>(_op, context)
+            auto [lo, hi] = bounds<float>(as<ClipObj>(_op));
+            auto clip = get_simd_ops<float>().clip;
+            HalfRows rows{cast};
+            return doPrepare<uint16_t>(
+                _op, [=](uint16_t *out, const uint16_t *in, size_t n)
+                {
+                    rows.unary(out, in, n,
+                               [&](float *fout, const float *fin, size_t m)
+                               { clip(fout, fin, m, lo, hi); });
+                });
+        }
 
+        Step prepare(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            const auto &cast = get_simd_kernels().cast;
             int dataTypeIdx = _op->getDType().getIndex();
             switch (dataTypeIdx)
             {
                 CASE(1); // DataType::Float32
-                break;
+                CASE(2); // DataType::UInt8
+                CASE(3); // DataType::Int8
+                CASE(6); // DataType::Int32
                 CASE(12); // DataType::UInt32
-                break;
+            case 10: // DataType::Float16
+                return doPrepareHalf(_op, cast.f16());
+            case 16: // DataType::BFloat16
+                return doPrepareHalf(_op, cast.bf16());
             default:
                 IT_TODO_HALT();
             }
         }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            prepare(_op, context)();
+        }
     };
 
     REGISTER_KERNEL(Device::CPU, OpType::Relu, NativeUnary, "reluNaive_CPU");
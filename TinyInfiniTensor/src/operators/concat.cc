@@ -39,4 +39,8 @@ std::string ConcatObj::toString() const {
     return os.str();
 }
 
+vector<int> ConcatObj::getOpAttrVector() const {
+    return {type.underlying(), dim};
+}
+
 } // namespace infini
@@ -0,0 +1,128 @@
+#include "operators/fused_element_wise.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    FusedElementWiseObj::FusedElementWiseObj(GraphObj *graph, TensorVec inputs,
+                                             Tensor output,
+                                             vector<Instruction> program)
+        : OperatorObj(OpType::FusedElementWise, inputs, {output}),
+          program(std::move(program))
+    {
+        IT_ASSERT(!this->program.empty());
+        int nSlots = this->inputs.size();
+        for (const auto &instr : this->program)
+        {
+            IT_ASSERT(instr.a >= 0 && instr.a < nSlots && instr.b < nSlots);
+            ++nSlots;
+        }
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> FusedElementWiseObj::inferShape(const TensorVec &inputs)
+    {
+        Shape res = inputs[0]->getDims();
+        for (size_t i = 1; i < inputs.size(); ++i)
+            res = infer_broadcast(res, inputs[i]->getDims());
+        return {{res}};
+    }
+
+    vector<DataType> FusedElementWiseObj::inferDataType(const TensorVec &inputs) const
+    {
+        return {program.back().dtype};
+    }
+
+    std::string FusedElementWiseObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        for (const auto &instr : program)
+            os << instr.type.toString() << ",";
+        os << "inputs=";
+        vector<UidBaseType> guids;
+        for (const auto &input : inputs)
+            guids.emplace_back(input->getGuid());
+        os << vecToString(guids) << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+    vector<int> FusedElementWiseObj::getOpAttrVector() const
+    {
+        vector<int> ret{type.underlying()};
+        for (const auto &instr : program)
+        {
+            bool isCast = instr.type == OpType::Cast;
+            ret.insert(ret.end(), {instr.type.underlying(), instr.a, instr.b,
+                                   instr.dtype.getIndex(),
+                                   isCast ? int(instr.castType) : 0});
+            append_float_attr(ret, instr.min);
+            append_float_attr(ret, instr.max);
+        }
+        return ret;
+    }
+
+    static bool isFusibleCast(CastType castType)
+    {
+        return castType == CastType::Float2Int32 ||
+               castType == CastType::Int322Float ||
+               castType == CastType::Float2Float;
+    }
+
+    bool FusedElementWiseObj::isFusible(const Operator &op)
+    {
+        switch (op->getOpType().underlying())
+        {
+        case OpType::Add:
+        case OpType::Sub:
+        case OpType::Mul:
+        case OpType::Div:
+        case OpType::Relu:
+        case OpType::Clip:
+        {
+            auto dtype = op->getOutput()->getDType();
+            for (const auto &input : op->getInputs())
+                if (!(input->getDType() == dtype))
+                    return false;
+            return dtype == DataType::Float32 || dtype == DataType::UInt32;
+        }
+        case OpType::Cast:
+            return isFusibleCast(as<CastObj>(op)->getType());
+        case OpType::FusedElementWise:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    vector<FusedElementWiseObj::Instruction>
+    FusedElementWiseObj::programOf(const Operator &op)
+    {
+        IT_ASSERT(isFusible(op));
+        if (auto fused = as<FusedElementWiseObj>(op))
+            return fused->getProgram();
+        Instruction instr{op->getOpType(), 0, -1, op->getOutput()->getDType(),
+                          std::nullopt, std::nullopt, CastType::Float2Float};
+        switch (op->getOpType().underlying())
+        {
+        case OpType::Add:
+        case OpType::Sub:
+        case OpType::Mul:
+        case OpType::Div:
+            instr.b = 1;
+            break;
+        case OpType::Clip:
+            instr.min = as<ClipObj>(op)->getMin();
+            instr.max = as<ClipObj>(op)->getMax();
+            break;
+        case OpType::Cast:
+            instr.castType = as<CastObj>(op)->getType();
+            break;
+        default:
+            break;
+        }
+        return {instr};
+    }
+
+} // namespace infini
@@ -22,6 +22,11 @@ namespace infini
         return os.str();
     }
 
+    vector<int> MatmulObj::getOpAttrVector() const
+    {
+        return {type.underlying(), transA, transB};
+    }
+
     optional<vector<Shape>> MatmulObj::inferShape(const TensorVec &inputs)
     {
         // =================================== 作业 ===================================
@@ -43,4 +48,13 @@ namespace infini
         return {{dimC}};
     }
 
+    vector<DataType> MatmulObj::inferDataType(const TensorVec &inputs) const
+    {
+        auto dtype = inputs[0]->getDType();
+        IT_ASSERT(inputs[1]->getDType() == dtype);
+        if (dtype == DataType::Int8)
+            return {DataType::Int32};
+        return {dtype};
+    }
+
 } // namespace infini
\ No newline at end of file
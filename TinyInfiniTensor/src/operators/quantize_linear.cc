@@ -0,0 +1,116 @@
+#include "operators/quantize_linear.h"
+#include "utils/operator_utils.h"
+
+namespace infini {
+
+namespace {
+
+// Resolves a negative channel axis and checks that there is one scale and
+// zero point per channel, or a single pair.
+bool normalizeParams(QuantParams &params, const Shape &dims) {
+    if (params.scales.empty() ||
+        params.scales.size() != params.zeroPoints.size())
+        return false;
+    if (params.isPerTensor())
+        return true;
+    int rank = dims.size();
+    if (params.axis < -rank || params.axis >= rank)
+        return false;
+    params.axis = get_real_axis(params.axis, rank);
+    return params.scales.size() == size_t(dims[params.axis]);
+}
+
+void appendParams(vector<int> &attrs, const QuantParams &params) {
+    attrs.emplace_back(params.isPerTensor() ? -1 : params.axis);
+    for (float scale : params.scales)
+        append_float_attr(attrs, scale);
+    attrs.insert(attrs.end(), params.zeroPoints.begin(),
+                 params.zeroPoints.end());
+}
+
+void printParams(std::ostream &os, const QuantParams &params) {
+    os << "scale=" << vecToString(params.scales) << ",";
+    os << "zeroPoint=" << vecToString(params.zeroPoints) << ",";
+    if (!params.isPerTensor())
+        os << "axis=" << params.axis << ",";
+}
+
+} // namespace
+
+QuantizeLinearObj::QuantizeLinearObj(GraphObj *graph, Tensor input,
+                                     Tensor output, QuantParams _params,
+                                     DataType outputType)
+    : OperatorObj(OpType::QuantizeLinear, {input}, {output}),
+      params(std::move(_params)), outputType(outputType) {
+    IT_ASSERT(input->getDType() == DataType::Float32);
+    IT_ASSERT(outputType == DataType::Int8 || outputType == DataType::UInt8);
+    IT_ASSERT(normalizeParams(params, input->getDims()));
+    IT_ASSERT(checkValid(graph));
+}
+
+optional<vector<Shape>>
+QuantizeLinearObj::inferShape(const TensorVec &inputs) {
+    return {{inputs[0]->getDims()}};
+}
+
+vector<DataType>
+QuantizeLinearObj::inferDataType(const TensorVec &inputs) const {
+    return {outputType};
+}
+
+std::string QuantizeLinearObj::toString() const {
+    std::ostringstream os;
+    os << type.toString() << "[" << getGuid() << "]";
+    os << "(";
+    os << vecToString(inputs[0]->getDims()) << ",";
+    printParams(os, params);
+    os << "input=" << inputs[0]->getGuid() << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+vector<int> QuantizeLinearObj::getOpAttrVector() const {
+    vector<int> ret{type.underlying(), outputType.getIndex()};
+    appendParams(ret, params);
+    return ret;
+}
+
+DequantizeLinearObj::DequantizeLinearObj(GraphObj *graph, Tensor input,
+                                         Tensor output, QuantParams _params)
+    : OperatorObj(OpType::DequantizeLinear, {input}, {output}),
+      params(std::move(_params)) {
+    auto dtype = input->getDType();
+    IT_ASSERT(dtype == DataType::Int8 || dtype == DataType::UInt8 ||
+              dtype == DataType::Int32);
+    IT_ASSERT(normalizeParams(params, input->getDims()));
+    IT_ASSERT(checkValid(graph));
+}
+
+optional<vector<Shape>>
+DequantizeLinearObj::inferShape(const TensorVec &inputs) {
+    return {{inputs[0]->getDims()}};
+}
+
+vector<DataType>
+DequantizeLinearObj::inferDataType(const TensorVec &inputs) const {
+    return {DataType::Float32};
+}
+
+std::string DequantizeLinearObj::toString() const {
+    std::ostringstream os;
+    os << type.toString() << "[" << getGuid() << "]";
+    os << "(";
+    os << vecToString(inputs[0]->getDims()) << ",";
+    printParams(os, params);
+    os << "input=" << inputs[0]->getGuid() << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+vector<int> DequantizeLinearObj::getOpAttrVector() const {
+    vector<int> ret{type.underlying()};
+    appendParams(ret, params);
+    return ret;
+}
+
+} // namespace infini
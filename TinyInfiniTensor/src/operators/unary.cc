@@ -1,4 +1,5 @@
 #include "operators/unary.h"
+#include "utils/operator_utils.h"
 
 namespace infini
 {
@@ -53,6 +54,14 @@ namespace infini
         return os.str();
     }
 
+    vector<int> ClipObj::getOpAttrVector() const
+    {
+        vector<int> ret{type.underlying()};
+        append_float_attr(ret, minValue);
+        append_float_attr(ret, maxValue);
+        return ret;
+    }
+
     CastObj::CastObj(GraphObj *graph, Tensor input, Tensor output, CastType type)
         : OperatorObj(OpType::Cast, {input}, {output}), castType(type)
     {
@@ -88,6 +97,11 @@ namespace infini
         return os.str();
     }
 
+    vector<int> CastObj::getOpAttrVector() const
+    {
+        return {type.underlying(), int(castType)};
+    }
+
     DataType CastObj::getOutputDataType() const
     {
         switch (castType)
@@ -0,0 +1,64 @@
+#include "utils/broadcast.h"
+
+namespace infini {
+
+namespace {
+vector<vector<size_t>> contiguousStrides(const vector<Shape> &inputs) {
+    vector<vector<size_t>> ret;
+    for (const auto &shape : inputs)
+        ret.emplace_back(TensorObj::contiguousStrides(shape));
+    return ret;
+}
+} // namespace
+
+BroadcastIterator::BroadcastIterator(const Shape &output,
+                                     const vector<Shape> &inputs)
+    : BroadcastIterator(output, inputs, contiguousStrides(inputs)) {}
+
+BroadcastIterator::BroadcastIterator(
+    const Shape &output, const vector<Shape> &inputs,
+    const vector<vector<size_t>> &inputStrides)
+    : strides(inputs.size()), total(1) {
+    size_t rank = output.size();
+    for (auto d : output)
+        total *= d;
+
+    // Right-align every input and take its strides, 0 on broadcast.
+    vector<vector<size_t>> full(inputs.size(), vector<size_t>(rank, 0));
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const auto &shape = inputs[i];
+        IT_ASSERT(shape.size() <= rank && inputStrides[i].size() == shape.size());
+        for (size_t j = shape.size(), d = rank; j-- > 0;) {
+            --d;
+            IT_ASSERT(shape[j] == output[d] || shape[j] == 1);
+            if (shape[j] == output[d] && output[d] != 1)
+                full[i][d] = inputStrides[i][j];
+        }
+    }
+
+    // Drop extent-1 dims and merge an outer dim into the inner one whenever
+    // every input is laid out contiguously across the pair.
+    for (size_t d = 0; d < rank; ++d) {
+        if (output[d] == 1)
+            continue;
+        bool mergeable = !dims.empty();
+        for (size_t i = 0; i < inputs.size() && mergeable; ++i)
+            mergeable = strides[i].back() == full[i][d] * output[d];
+        if (mergeable) {
+            dims.back() *= output[d];
+            for (size_t i = 0; i < inputs.size(); ++i)
+                strides[i].back() = full[i][d];
+        } else {
+            dims.emplace_back(output[d]);
+            for (size_t i = 0; i < inputs.size(); ++i)
+                strides[i].emplace_back(full[i][d]);
+        }
+    }
+    // Every input has the output layout exactly when everything merged into
+    // one unit-stride row.
+    contiguous = dims.size() <= 1;
+    for (size_t i = 0; i < inputs.size() && !dims.empty(); ++i)
+        contiguous &= strides[i][0] == 1;
+}
+
+} // namespace infini
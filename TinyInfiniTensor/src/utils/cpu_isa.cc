@@ -0,0 +1,51 @@
+#include "utils/cpu_isa.h"
+#include <cstdlib>
+#include <initializer_list>
+#include <strings.h>
+
+namespace infini {
+
+static CpuIsa detect_hardware_isa() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return CpuIsa::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+        __builtin_cpu_supports("f16c"))
+        return CpuIsa::AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return CpuIsa::SSE41;
+#endif
+    return CpuIsa::Scalar;
+}
+
+CpuIsa detect_cpu_isa() {
+    static const CpuIsa isa = [] {
+        CpuIsa hw = detect_hardware_isa();
+        const char *env = std::getenv("INFINI_CPU_ISA");
+        if (!env)
+            return hw;
+        for (auto cap : {CpuIsa::Scalar, CpuIsa::SSE41, CpuIsa::AVX2,
+                         CpuIsa::AVX512})
+            if (strcasecmp(env, cpu_isa_name(cap)) == 0)
+                return cap < hw ? cap : hw;
+        return hw;
+    }();
+    return isa;
+}
+
+const char *cpu_isa_name(CpuIsa isa) {
+    switch (isa) {
+    case CpuIsa::Scalar:
+        return "scalar";
+    case CpuIsa::SSE41:
+        return "sse4.1";
+    case CpuIsa::AVX2:
+        return "avx2";
+    case CpuIsa::AVX512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+} // namespace infini
@@ -0,0 +1,73 @@
+#include "utils/logger.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <mutex>
+#include <strings.h>
+
+namespace infini {
+
+static LogLevel level_from_env() {
+    const char *env = std::getenv("INFINI_LOG_LEVEL");
+    if (env)
+        for (auto level : {LogLevel::Trace, LogLevel::Debug, LogLevel::Info,
+                           LogLevel::Warn, LogLevel::Error, LogLevel::Off})
+            if (strcasecmp(env, log_level_name(level)) == 0)
+                return level;
+    return LogLevel::Info;
+}
+
+static std::atomic<LogLevel> &runtime_level() {
+    static std::atomic<LogLevel> level(level_from_env());
+    return level;
+}
+
+LogLevel get_log_level() {
+    return runtime_level().load(std::memory_order_relaxed);
+}
+
+void set_log_level(LogLevel level) {
+    runtime_level().store(level, std::memory_order_relaxed);
+}
+
+const char *log_level_name(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace:
+        return "trace";
+    case LogLevel::Debug:
+        return "debug";
+    case LogLevel::Info:
+        return "info";
+    case LogLevel::Warn:
+        return "warn";
+    case LogLevel::Error:
+        return "error";
+    case LogLevel::Off:
+        return "off";
+    }
+    return "unknown";
+}
+
+void log_write(LogLevel level, const char *file, int line,
+               const std::string &msg) {
+    static std::mutex mutex;
+    const char *base = std::strrchr(file, '/');
+    base = base ? base + 1 : file;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::clog << "[" << log_level_name(level) << "] " << base << ":" << line
+              << " " << msg << '\n';
+}
+
+LogScopeTimer::~LogScopeTimer() {
+    if (!log_enabled(LogLevel::Debug))
+        return;
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::ostringstream oss;
+    oss << "pass=" << name << " ms=" << elapsed.count();
+    log_write(LogLevel::Debug, file, line, oss.str());
+}
+
+} // namespace infini
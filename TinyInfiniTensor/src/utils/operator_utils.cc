@@ -1,5 +1,6 @@
 #include "utils/operator_utils.h"
 #include "core/runtime.h"
+#include "utils/half.h"
 
 namespace infini {
 
@@ -74,4 +75,9 @@ std::string get_kernel_attrs_str(const KernelAttrs &kernelAttrs) {
     return deviceStr + ", " + opStr;
 }
 
+void append_float_attr(vector<int> &attrs, std::optional<float> value) {
+    attrs.emplace_back(value.has_value());
+    attrs.emplace_back(value ? int(float_bits(*value)) : 0);
+}
+
 } // namespace infini
@@ -0,0 +1,167 @@
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace infini {
+
+namespace {
+// The pool a worker thread belongs to and the index of its queue.
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local size_t currentQueue = 0;
+} // namespace
+
+ThreadPool::ThreadPool(size_t nThreads) {
+    nThreads = std::max<size_t>(1, nThreads);
+    for (size_t i = 0; i < nThreads; ++i)
+        queues.emplace_back(std::make_unique<Queue>());
+    for (size_t i = 1; i < nThreads; ++i)
+        workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+ThreadPool &ThreadPool::getInstance() {
+    static ThreadPool pool([] {
+        if (const char *env = std::getenv("INFINI_NUM_THREADS")) {
+            long n = std::atol(env);
+            if (n > 0)
+                return size_t(n);
+        }
+        return size_t(std::max(1u, std::thread::hardware_concurrency()));
+    }());
+    return pool;
+}
+
+size_t ThreadPool::localQueue() const {
+    return currentPool == this ? currentQueue : 0;
+}
+
+void ThreadPool::submit(TaskGroup &group, std::function<void()> task) {
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    auto &queue = *queues[localQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back({std::move(task), &group});
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    if (!workers.empty()) {
+        // Taking the lock orders the notification after a sleeping worker's
+        // check of `queued`, so the wakeup cannot be lost.
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeup.notify_one();
+    }
+}
+
+bool ThreadPool::tryPop(size_t self, Task &task) {
+    if (queued.load(std::memory_order_acquire) == 0)
+        return false;
+    // Newest own task first for locality, then the oldest task of others.
+    {
+        auto &queue = *queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    for (size_t k = 1; k < queues.size(); ++k) {
+        auto &queue = *queues[(self + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::execute(Task &task) {
+    try {
+        task.fn();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(task.group->mutex);
+        if (!task.group->error)
+            task.group->error = std::current_exception();
+    }
+    // Release the task's closure before the waiter can observe completion.
+    task.fn = nullptr;
+    task.group->pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void ThreadPool::wait(TaskGroup &group) {
+    size_t self = localQueue();
+    Task task;
+    while (group.pending.load(std::memory_order_acquire) != 0) {
+        if (tryPop(self, task))
+            execute(task);
+        else
+            std::this_thread::yield();
+    }
+    if (group.error)
+        std::rethrow_exception(group.error);
+}
+
+void ThreadPool::workerLoop(size_t self) {
+    currentPool = this;
+    currentQueue = self;
+    Task task;
+    while (true) {
+        if (tryPop(self, task)) {
+            execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeup.wait(lock, [&] {
+            return stopping || queued.load(std::memory_order_acquire) != 0;
+        });
+        if (stopping)
+            return;
+    }
+}
+
+namespace detail {
+
+void parallel_for(size_t n, void (*fn)(const void *, size_t, size_t),
+                  const void *f) {
+    auto &pool = ThreadPool::getInstance();
+    if (pool.numThreads() == 1) {
+        fn(f, 0, n);
+        return;
+    }
+    // A few chunks per thread balance uneven work without paying a task per
+    // index.
+    size_t nChunks = std::min(n, pool.numThreads() * 4);
+    auto bound = [&](size_t c) {
+        return n / nChunks * c + std::min(c, n % nChunks);
+    };
+    ThreadPool::TaskGroup group;
+    for (size_t c = 1; c < nChunks; ++c)
+        pool.submit(group, [&, c] { fn(f, bound(c), bound(c + 1)); });
+    try {
+        fn(f, bound(0), bound(1));
+    } catch (...) {
+        // Chunks still reference `f` and `group`; let them finish first.
+        try {
+            pool.wait(group);
+        } catch (...) {
+        }
+        throw;
+    }
+    pool.wait(group);
+}
+
+} // namespace detail
+
+} // namespace infini
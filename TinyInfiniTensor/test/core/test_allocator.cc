@@ -7,6 +7,14 @@
 
 namespace infini
 {
+    // The byte counts expected by some tests assume 8-byte alignment.
+    static Runtime byteExactRuntime()
+    {
+        auto runtime = make_ref<NativeCpuRuntimeObj>();
+        runtime->setAlignment(sizeof(uint64_t));
+        return runtime;
+    }
+
     TEST(Allocator, testAlloc)
     {
         Shape shape = Shape{1, 2, 2, 3};
@@ -71,4 +79,79 @@ namespace infini
         EXPECT_EQ(ptr1, ptr2);
     }
 
+    TEST(Allocator, testGrowAfterGetPtr)
+    {
+        Runtime runtime = byteExactRuntime();
+        Allocator allocator = Allocator(runtime);
+        size_t offset = allocator.alloc(64);
+        allocator.getPtr();
+        // Reusing the memory of a freed block keeps the arena
+        allocator.free(offset, 64);
+        EXPECT_EQ(allocator.alloc(32), offset);
+        allocator.getPtr();
+        EXPECT_EQ(allocator.getPeak(), 64u);
+        // Going past it grows the arena
+        allocator.alloc(128);
+        EXPECT_EQ(allocator.getPeak(), 160u);
+        allocator.getPtr();
+        EXPECT_EQ(allocator.getPeak(), 160u);
+    }
+
+    TEST(Allocator, testBestFit)
+    {
+        Runtime runtime = byteExactRuntime();
+        Allocator allocator = Allocator(runtime);
+        // allocate a(64)->b(16)->c(32)->d(16)->e(16)
+        size_t offsetA = allocator.alloc(64);
+        allocator.alloc(16);
+        size_t offsetC = allocator.alloc(32);
+        allocator.alloc(16);
+        allocator.alloc(16);
+        // free a and c, then allocate f(24): c is the tightest fit
+        allocator.free(offsetA, 64);
+        allocator.free(offsetC, 32);
+        size_t offsetF = allocator.alloc(24);
+        EXPECT_EQ(offsetF, offsetC);
+        size_t offsetG = allocator.alloc(48);
+        EXPECT_EQ(offsetG, offsetA);
+        EXPECT_EQ(allocator.getPeak(), 144u);
+    }
+
+    TEST(Allocator, testMergeBothNeighbours)
+    {
+        Runtime runtime = byteExactRuntime();
+        Allocator allocator = Allocator(runtime);
+        // allocate a->b->c->d
+        size_t offsetA = allocator.alloc(32);
+        size_t offsetB = allocator.alloc(32);
+        size_t offsetC = allocator.alloc(32);
+        allocator.alloc(32);
+        // free a and c first, then b, which must join a and c
+        allocator.free(offsetA, 32);
+        allocator.free(offsetC, 32);
+        allocator.free(offsetB, 32);
+        allocator.info();
+        size_t offsetE = allocator.alloc(96);
+        EXPECT_EQ(offsetE, offsetA);
+        EXPECT_EQ(allocator.getPeak(), 128u);
+    }
+
+    TEST(Allocator, testAlignedArena)
+    {
+        auto runtime = NativeCpuRuntimeObj::getInstance();
+        EXPECT_EQ(runtime->getAlignment(), 64u);
+        Allocator allocator = Allocator(runtime);
+        allocator.alloc(4);
+        EXPECT_EQ(allocator.alloc(4), 64u);
+        // Small blocks come from the heap, large ones are mapped; both are
+        // aligned and writable
+        for (size_t bytes : {size_t(100), NativeCpuRuntimeObj::hugePageThreshold})
+        {
+            auto ptr = static_cast<char *>(runtime->alloc(bytes));
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0u);
+            ptr[0] = ptr[bytes - 1] = 1;
+            runtime->dealloc(ptr);
+        }
+    }
+
 } // namespace infini
@@ -0,0 +1,51 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    static vector<DenseGraph::Id> toVector(DenseGraph::IdRange range)
+    {
+        return vector<DenseGraph::Id>(range.begin(), range.end());
+    }
+
+    TEST(DenseGraph, Adjacency)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({4}, DataType::Float32);
+        auto relu = g->addOp<ReluObj>(x, nullptr);
+        Tensor r = relu->getOutput();
+        auto square = g->addOp<MulObj>(r, r, nullptr);
+        auto add = g->addOp<AddObj>(square->getOutput(), x, nullptr);
+
+        const auto &d = g->getDenseGraph();
+        ASSERT_EQ(d.numOps(), 3u);
+        ASSERT_EQ(d.numTensors(), 4u);
+        auto idX = d.tensorId(x.get()), idR = d.tensorId(r.get());
+        auto idRelu = d.opId(relu.get()), idSquare = d.opId(square.get()),
+             idAdd = d.opId(add.get());
+        EXPECT_EQ(d.getOp(idSquare), square.get());
+        EXPECT_EQ(d.source(idX), DenseGraph::None);
+        EXPECT_EQ(d.source(idR), idRelu);
+        // One target per use, one successor per consumer
+        EXPECT_EQ(toVector(d.targets(idR)), (vector<DenseGraph::Id>{idSquare, idSquare}));
+        EXPECT_EQ(toVector(d.targets(idX)), (vector<DenseGraph::Id>{idRelu, idAdd}));
+        EXPECT_EQ(toVector(d.successors(idRelu)), vector<DenseGraph::Id>{idSquare});
+        EXPECT_EQ(toVector(d.predecessors(idAdd)), vector<DenseGraph::Id>{idSquare});
+        EXPECT_EQ(toVector(d.inputs(idSquare)), (vector<DenseGraph::Id>{idR, idR}));
+
+        // The snapshot is rebuilt after a structural change
+        auto relu2 = g->addOp<ReluObj>(add->getOutput(), nullptr);
+        const auto &d2 = g->getDenseGraph();
+        EXPECT_EQ(d2.numOps(), 4u);
+        EXPECT_EQ(toVector(d2.successors(d2.opId(add.get()))),
+                  vector<DenseGraph::Id>{d2.opId(relu2.get())});
+        EXPECT_EQ(g->getOutputs(), TensorVec{relu2->getOutput()});
+        EXPECT_EQ(g->getInputs(), TensorVec{x});
+    }
+}
@@ -1,8 +1,12 @@
 #include "core/graph.h"
 #include "core/kernel.h"
 #include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
 #include "operators/matmul.h"
+#include "operators/quantize_linear.h"
 #include "operators/transpose.h"
+#include "operators/unary.h"
 
 #include "test.h"
 
@@ -37,4 +41,466 @@ namespace infini
         EXPECT_EQ(op->getTransA(), false);
         EXPECT_EQ(op->getTransB(), true);
     }
-}
\ No newline at end of file
+
+    TEST(Graph, TopoSort)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({1000}, DataType::Float32);
+        Tensor y = g->addTensor({1}, DataType::Float32);
+        Tensor a = g->addTensor({1000}, DataType::Float32);
+        Tensor b = g->addTensor({1000}, DataType::Float32);
+        Tensor s = g->addTensor({1}, DataType::Float32);
+        Tensor o = g->addTensor({1000}, DataType::Float32);
+        // Consumers are added before their producers
+        auto add = g->addOpWithOutputs<AddObj>(b, s, o);
+        auto relu3 = g->addOpWithOutputs<ReluObj>(a, b);
+        auto relu1 = g->addOpWithOutputs<ReluObj>(x, a);
+        auto relu2 = g->addOpWithOutputs<ReluObj>(y, s);
+
+        ASSERT_TRUE(g->topo_sort());
+        EXPECT_EQ(g->getOperators(), (OpVec{relu1, relu3, relu2, add}));
+        // relu2 allocates less than relu1, and relu3 releases as much as it
+        // allocates
+        ASSERT_TRUE(g->topo_sort(TopoOrder::MemoryAware));
+        EXPECT_EQ(g->getOperators(), (OpVec{relu2, relu1, relu3, add}));
+    }
+
+    TEST(Graph, TopoSortCycle)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({1}, DataType::Float32);
+        Tensor b = g->addTensor({1}, DataType::Float32);
+        g->addOpWithOutputs<ReluObj>(a, b);
+        g->addOpWithOutputs<ReluObj>(b, a);
+        EXPECT_FALSE(g->topo_sort());
+    }
+
+    TEST(Graph, RemoveAndLookup)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({2}, DataType::Float32);
+        Tensor b = g->addTensor({2}, DataType::Float32);
+        Tensor c = g->addTensor({2}, DataType::Float32);
+        auto relu1 = g->addOpWithOutputs<ReluObj>(a, b);
+        auto relu2 = g->addOpWithOutputs<ReluObj>(b, c);
+        EXPECT_EQ(g->getTensor(b->getFuid()), b);
+        EXPECT_TRUE(g->hasOperator(relu2));
+
+        g->removeTensor(a);
+        g->removeOperator(relu1);
+        EXPECT_EQ(g->getTensors(), (TensorVec{b, c}));
+        EXPECT_EQ(g->getOperators(), OpVec{relu2});
+        EXPECT_EQ(g->getTensor(a->getFuid()), nullptr);
+        EXPECT_FALSE(g->hasOperator(relu1));
+        // Positions behind the removed entries are still found
+        EXPECT_EQ(g->getTensor(c->getFuid()), c);
+        EXPECT_TRUE(g->hasOperator(relu2));
+        // Removing twice is a no-op
+        g->removeTensor(a);
+        EXPECT_EQ(g->getTensors().size(), 2u);
+    }
+
+    TEST(Graph, OptimizeOnEdges)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i1 = g->addTensor({2, 3, 4}, DataType::Float32);
+        Tensor i2 = g->addTensor({2, 5, 3}, DataType::Float32);
+        Tensor t1 = g->addTensor({3, 4, 2}, DataType::Float32);
+        Tensor t2 = g->addTensor({2, 4, 3}, DataType::Float32);
+        Tensor t3 = g->addTensor({2, 3, 5}, DataType::Float32);
+        Tensor r = g->addTensor({2, 3, 5}, DataType::Float32);
+        Tensor o = g->addTensor({2, 4, 5}, DataType::Float32);
+        // The two transposes on i1 are not adjacent in the op list and
+        // compose into a swap of the last two dims.
+        g->addOpWithOutputs<TransposeObj>(i1, t1, Shape{1, 2, 0});
+        g->addOpWithOutputs<TransposeObj>(i2, t3, Shape{0, 2, 1});
+        g->addOpWithOutputs<TransposeObj>(t1, t2, Shape{2, 1, 0});
+        // t3 has another consumer, so its transpose must stay.
+        g->addOpWithOutputs<ReluObj>(t3, r);
+        auto matmul = g->addOpWithOutputs<MatmulObj>(t2, t3, o);
+        g->optimize();
+
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOperators().size(), 3u);
+        EXPECT_EQ(matmul->getInputs(0)->getFuid(), i1->getFuid());
+        EXPECT_TRUE(matmul->getTransA());
+        EXPECT_EQ(matmul->getInputs(1), i2);
+        EXPECT_TRUE(matmul->getTransB());
+        EXPECT_EQ(t3->getTargets().size(), 1u);
+        EXPECT_FALSE(g->hasTensor(t1));
+        EXPECT_FALSE(g->hasTensor(t2));
+    }
+
+    TEST(Graph, ExecutionPlan)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 3}, DataType::Float32);
+        auto b = g->addTensor({3}, DataType::Float32);
+        auto sum = g->addOp<AddObj>(a, b, nullptr)->getOutput();
+        auto y = g->addOp<ReluObj>(sum, nullptr)->getOutput();
+        g->dataMalloc();
+        a->setData(IncrementalGenerator());
+        b->setData(ValGenerator<-2>());
+
+        // The plan is built once and reused by every run.
+        const auto *plan = &g->getExecutionPlan();
+        EXPECT_EQ(plan->size(), 2u);
+        runtime->run(g);
+        EXPECT_EQ(&g->getExecutionPlan(), plan);
+        EXPECT_TRUE(y->equalData(vector<float>{0, 0, 0, 1, 2, 3}));
+        a->setData(ValGenerator<4>());
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(vector<float>{2, 2, 2, 2, 2, 2}));
+    }
+
+    TEST(Graph, ConcatInputsInPlace)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({1, 2, 3}, DataType::Float32);
+        auto b = g->addTensor({1, 1, 3}, DataType::Float32);
+        auto ra = g->addOp<ReluObj>(a, nullptr)->getOutput();
+        auto rb = g->addOp<ReluObj>(b, nullptr)->getOutput();
+        auto c = g->addOp<ConcatObj>(TensorVec{ra, rb}, nullptr, 1)->getOutput();
+        auto y = g->addOp<ReluObj>(c, nullptr)->getOutput();
+        g->dataMalloc();
+
+        // Both producers write straight into their slice of the output.
+        EXPECT_EQ(ra->getViewBase(), c);
+        EXPECT_EQ(rb->getViewBase(), c);
+        EXPECT_EQ(ra->getRawDataPtr<float *>(), c->getRawDataPtr<float *>());
+        EXPECT_EQ(rb->getRawDataPtr<float *>(),
+                  c->getRawDataPtr<float *>() + 6);
+        a->setData(IncrementalGenerator());
+        b->setData(ValGenerator<-1>());
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(vector<float>{0, 1, 2, 3, 4, 5, 0, 0, 0}));
+    }
+
+    TEST(Graph, TransposeView)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto b = g->addTensor({2, 4, 3}, DataType::Float32);
+        auto w = g->addTensor({4, 2}, DataType::Float32);
+        auto t = g->addOp<TransposeObj>(a, nullptr, vector<int>{0, 2, 1})
+                     ->getOutput();
+        auto sum = g->addOp<AddObj>(t, b, nullptr)->getOutput();
+        auto u = g->addOp<TransposeObj>(a, nullptr, vector<int>{1, 0, 2})
+                     ->getOutput();
+        auto prod = g->addOp<MatmulObj>(u, w, nullptr)->getOutput();
+        g->dataMalloc();
+
+        // Both transposes are read in place by their consumers.
+        EXPECT_EQ(t->getViewBase(), a);
+        EXPECT_EQ(u->getViewBase(), a);
+        EXPECT_FALSE(t->isContiguous());
+        EXPECT_EQ(t->getStrides(), (vector<size_t>{12, 1, 4}));
+        EXPECT_EQ(u->getStrides(), (vector<size_t>{4, 12, 1}));
+        a->setData(IncrementalGenerator());
+        b->setData(IncrementalGenerator());
+        w->setData(IncrementalGenerator());
+        runtime->run(g);
+
+        vector<float> expectSum(24), expectProd(12, 0);
+        for (int i = 0; i < 2; ++i)
+            for (int j = 0; j < 4; ++j)
+                for (int k = 0; k < 3; ++k)
+                    expectSum[i * 12 + j * 3 + k] =
+                        (i * 12 + k * 4 + j) + (i * 12 + j * 3 + k);
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 2; ++j)
+                for (int n = 0; n < 2; ++n)
+                    for (int k = 0; k < 4; ++k)
+                        expectProd[i * 4 + j * 2 + n] +=
+                            (j * 12 + i * 4 + k) * (k * 2 + n);
+        EXPECT_TRUE(sum->equalData(expectSum));
+        EXPECT_TRUE(prod->equalData(expectProd));
+    }
+
+    TEST(Graph, InPlace)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 3}, DataType::Float32);
+        auto bias = g->addTensor({3}, DataType::Float32);
+        auto x = g->addOp<AddObj>(a, bias, nullptr)->getOutput();
+        auto r = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        auto c = g->addOp<ClipObj>(r, nullptr, 0.f, 3.f)->getOutput();
+        // A residual: `c` is still read after the Relu that consumes it.
+        auto y = g->addOp<ReluObj>(c, nullptr)->getOutput();
+        auto z = g->addOp<AddObj>(c, y, nullptr)->getOutput();
+        g->dataMalloc();
+
+        // The whole chain runs in one buffer; graph inputs are left alone.
+        auto ptr = z->getRawDataPtr<float *>();
+        for (auto t : {x, r, c})
+            EXPECT_EQ(t->getRawDataPtr<float *>(), ptr);
+        EXPECT_NE(y->getRawDataPtr<float *>(), ptr);
+        EXPECT_NE(a->getRawDataPtr<float *>(), ptr);
+        a->setData(IncrementalGenerator());
+        bias->setData(ValGenerator<-1>());
+        for (int i = 0; i < 2; ++i)
+        {
+            runtime->run(g);
+            EXPECT_TRUE(z->equalData(vector<float>{0, 0, 2, 4, 6, 6}));
+        }
+    }
+
+    TEST(Graph, ReshapeInputs)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 3}, DataType::Float32);
+        auto bias = g->addTensor({3}, DataType::Float32);
+        auto w = g->addTensor({3, 2}, DataType::Float32);
+        auto h = g->addOp<AddObj>(x, bias, nullptr)->getOutput();
+        auto r = g->addOp<ReluObj>(h, nullptr)->getOutput();
+        auto y = g->addOp<MatmulObj>(r, w, nullptr)->getOutput();
+        g->dataMalloc();
+
+        auto runBatch = [&](int batch)
+        {
+            g->reshapeInputs({{batch, 3}, {3}, {3, 2}});
+            EXPECT_EQ(y->getDims(), (Shape{batch, 2}));
+            x->setData(IncrementalGenerator());
+            bias->setData(ValGenerator<-2>());
+            w->setData(OneGenerator());
+            runtime->run(g);
+            // Row i of x + bias is 3i - 2, 3i - 1, 3i.
+            vector<float> ans;
+            for (int i = 0; i < batch; ++i)
+            {
+                float sum = std::max(3 * i - 2, 0) + std::max(3 * i - 1, 0) +
+                            3 * i;
+                ans.insert(ans.end(), {sum, sum});
+            }
+            EXPECT_TRUE(y->equalData(ans));
+            return &g->getExecutionPlan();
+        };
+        runBatch(2);
+        auto *large = runBatch(16);
+        runBatch(4);
+        // Returning to a batch size seen before reuses its plans, since the
+        // arena only had to grow for the first large batch.
+        EXPECT_EQ(runBatch(16), large);
+    }
+
+    TEST(Graph, SinkDequantize)
+    {
+        // x is quantized per tensor and the weights w per output channel;
+        // powers of two keep the float reference exact.
+        QuantParams pa{{0.5f}, {0}};
+        QuantParams pb{{0.25f, 0.5f, 1.f, 2.f, 0.25f, 0.5f},
+                       {0, 0, 0, 0, 0, 0}};
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        vector<Graph> graphs;
+        vector<Tensor> outputs;
+        for (bool optimize : {false, true})
+        {
+            Graph g = graphs.emplace_back(make_ref<GraphObj>(runtime));
+            auto x = g->addTensor({8, 4}, DataType::Float32);
+            auto w = g->addTensor({8, 6}, DataType::Int8);
+            auto q = g->addOp<QuantizeLinearObj>(x, nullptr, pa)->getOutput();
+            auto a = g->addOp<DequantizeLinearObj>(q, nullptr, pa)->getOutput();
+            auto t = g->addOp<TransposeObj>(a, nullptr, Shape{1, 0})
+                         ->getOutput();
+            auto r = g->addOp<ReluObj>(t, nullptr)->getOutput();
+            auto b = g->addOp<DequantizeLinearObj>(w, nullptr, pb)->getOutput();
+            auto y = g->addOp<MatmulObj>(r, b, nullptr)->getOutput();
+            if (optimize)
+            {
+                g->optimize();
+                EXPECT_TRUE(g->checkValid());
+                // Q -> Transpose -> Clip -> MatMul -> DQ, all on integers
+                // after the quantization.
+                EXPECT_EQ(g->getOperators().size(), 5u);
+                auto dq = as<DequantizeLinearObj>(y->getSource());
+                ASSERT_TRUE(dq);
+                EXPECT_EQ(dq->getParams().axis, 1);
+                auto matmul = as<MatmulObj>(dq->getInputs(0)->getSource());
+                ASSERT_TRUE(matmul);
+                EXPECT_EQ(matmul->getOutDType(), DataType::Int32);
+                EXPECT_EQ(matmul->getInputs(1), w);
+                auto clip = matmul->getInputs(0)->getSource();
+                EXPECT_EQ(clip->getOpType(), OpType::Clip);
+                EXPECT_EQ(clip->getInputs(0)->getSource()->getOpType(),
+                          OpType::Transpose);
+            }
+            g->dataMalloc();
+            x->setData([](void *ptr, size_t size, DataType)
+                       {
+                           for (size_t i = 0; i < size; ++i)
+                               static_cast<float *>(ptr)[i] =
+                                   float(int(i % 13) - 6);
+                       });
+            w->setData([](void *ptr, size_t size, DataType)
+                       {
+                           for (size_t i = 0; i < size; ++i)
+                               static_cast<int8_t *>(ptr)[i] = i % 7 - 3;
+                       });
+            runtime->run(g);
+            outputs.emplace_back(y);
+        }
+        EXPECT_TRUE(outputs[0]->equalData(outputs[1]));
+    }
+
+    TEST(Graph, SinkDequantizeConcatClip)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        QuantParams params{{0.5f}, {2}};
+        auto q0 = g->addTensor({2, 3}, DataType::Int8);
+        auto q1 = g->addTensor({2, 5}, DataType::Int8);
+        auto a = g->addOp<DequantizeLinearObj>(q0, nullptr, params);
+        auto b = g->addOp<DequantizeLinearObj>(q1, nullptr, params);
+        auto c = g->addOp<ConcatObj>(
+            TensorVec{a->getOutput(), b->getOutput()}, nullptr, 1);
+        // The lower bound is a quantized value and the upper one is beyond
+        // the Int8 range; a bound between two values stays in float.
+        auto clip = g->addOp<ClipObj>(c->getOutput(), nullptr, -1.5f, 1e3f);
+        auto y = clip->getOutput();
+        auto off = g->addOp<ClipObj>(y, nullptr, 0.2f, std::nullopt);
+        g->optimize();
+
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOperators().size(), 4u);
+        auto dq = as<DequantizeLinearObj>(y->getSource());
+        ASSERT_TRUE(dq);
+        auto moved = as<ClipObj>(dq->getInputs(0)->getSource());
+        ASSERT_TRUE(moved);
+        EXPECT_EQ(moved->getMin(), std::optional<float>(-1.f));
+        EXPECT_FALSE(moved->getMax());
+        EXPECT_EQ(moved->getInputs(0)->getSource()->getOpType(),
+                  OpType::Concat);
+        EXPECT_EQ(off->getInputs(0), y);
+    }
+
+    TEST(Graph, FoldConstants)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({4, 2}, DataType::Float32);
+        auto w = g->addTensor({3, 2}, DataType::Float32);
+        auto bias = g->addTensor({3}, DataType::Float32);
+        auto qw = g->addTensor({3}, DataType::Int8);
+        w->setConstant(IncrementalGenerator());
+        bias->setConstant(ValGenerator<-2>());
+        qw->setConstant([](void *ptr, size_t size, DataType)
+                        { std::fill_n(static_cast<int8_t *>(ptr), size, 2); });
+        auto wt = g->addOp<TransposeObj>(w, nullptr, Shape{1, 0})->getOutput();
+        auto h = g->addOp<AddObj>(wt, bias, nullptr)->getOutput();
+        auto c = g->addOp<ReluObj>(h, nullptr)->getOutput();
+        auto y = g->addOp<MatmulObj>(x, c, nullptr)->getOutput();
+        auto dq = g->addOp<DequantizeLinearObj>(qw, nullptr,
+                                                QuantParams{{0.5f}, {0}});
+        auto z = g->addOp<AddObj>(y, dq->getOutput(), nullptr)->getOutput();
+        EXPECT_EQ(g->getInputs().size(), 1u);
+        g->optimize();
+
+        // The weight preprocessing is gone; the dequantization is kept.
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOperators().size(), 3u);
+        EXPECT_TRUE(g->hasOperator(dq));
+        EXPECT_FALSE(g->hasTensor(w));
+        EXPECT_FALSE(g->hasTensor(wt));
+        EXPECT_TRUE(c->isConstant());
+        EXPECT_FALSE(c->getSource());
+        EXPECT_TRUE(c->equalData(vector<float>{0, 0, 2, 0, 1, 3}));
+        EXPECT_EQ(g->getInputs(), (TensorVec{x}));
+
+        g->dataMalloc();
+        x->setData(IncrementalGenerator());
+        runtime->run(g);
+        EXPECT_TRUE(z->equalData(
+            vector<float>{1, 2, 4, 1, 4, 14, 1, 6, 24, 1, 8, 34}));
+        // Constants keep their data across new plans.
+        g->reshapeInputs({{2, 2}});
+        x->setData(IncrementalGenerator());
+        runtime->run(g);
+        EXPECT_TRUE(z->equalData(vector<float>{1, 2, 4, 1, 4, 14}));
+    }
+
+    TEST(Graph, ConstantConcatInput)
+    {
+        // A constant input is copied into its slice rather than placed there.
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2}, DataType::Float32);
+        auto w = g->addTensor({3}, DataType::Float32);
+        w->setConstant(IncrementalGenerator());
+        auto y = g->addOp<ConcatObj>(TensorVec{x, w}, nullptr, 0)->getOutput();
+        g->dataMalloc();
+        x->setData(ValGenerator<7>());
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(vector<float>{7, 7, 0, 1, 2}));
+    }
+
+    TEST(Graph, EliminateCommonSubexpressions)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 3}, DataType::Float32);
+        auto t1 = g->addOp<TransposeObj>(x, nullptr, Shape{1, 0});
+        auto t2 = g->addOp<TransposeObj>(x, nullptr, Shape{1, 0});
+        auto c1 = g->addOp<ClipObj>(t1->getOutput(), nullptr, 0.f, 1.f);
+        auto c2 = g->addOp<ClipObj>(t2->getOutput(), nullptr, 0.f, 1.f);
+        // Other attributes compute something else.
+        auto c3 = g->addOp<ClipObj>(t2->getOutput(), nullptr, 0.f, 2.f);
+        auto a1 = g->addOp<AddObj>(c1->getOutput(), c2->getOutput(), nullptr);
+        auto a2 = g->addOp<AddObj>(a1->getOutput(), c3->getOutput(), nullptr);
+        EXPECT_EQ(t1->hash(), t2->hash());
+        EXPECT_NE(c1->hash(), c2->hash());
+        g->eliminateCommonSubexpressions();
+
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOperators().size(), 5u);
+        EXPECT_FALSE(g->hasOperator(t2));
+        EXPECT_FALSE(g->hasOperator(c2));
+        EXPECT_EQ(c3->getInputs(0), t1->getOutput());
+        EXPECT_EQ(a1->getInputs(0), c1->getOutput());
+        EXPECT_EQ(a1->getInputs(1), c1->getOutput());
+        EXPECT_EQ(a2->getInputs(1), c3->getOutput());
+    }
+
+    TEST(Graph, EliminateDeadCode)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({4}, DataType::Float32);
+        auto unused = g->addTensor({4}, DataType::Float32);
+        auto y1 = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        auto y2 = g->addOp<AddObj>(y1, y1, nullptr)->getOutput();
+        auto dead = g->addOp<AddObj>(y2, unused, nullptr);
+        g->addOp<ReluObj>(dead->getOutput(), nullptr);
+        // Without designated outputs every tensor without consumers is one.
+        g->eliminateDeadCode();
+        EXPECT_EQ(g->getOperators().size(), 4u);
+
+        g->setOutputs({y1, y2});
+        g->optimize();
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOperators().size(), 2u);
+        EXPECT_FALSE(g->hasOperator(dead));
+        EXPECT_FALSE(g->hasTensor(unused));
+        EXPECT_EQ(g->getInputs(), (TensorVec{x}));
+        EXPECT_EQ(g->getOutputs(), (TensorVec{y1, y2}));
+
+        // y1 is read by the Add, which must not overwrite it in place.
+        g->dataMalloc();
+        x->setData([](void *ptr, size_t size, DataType)
+                   {
+                       for (size_t i = 0; i < size; ++i)
+                           static_cast<float *>(ptr)[i] = float(i) - 1.5f;
+                   });
+        runtime->run(g);
+        EXPECT_TRUE(y1->equalData(vector<float>{0, 0, 0.5, 1.5}));
+        EXPECT_TRUE(y2->equalData(vector<float>{0, 0, 1, 3}));
+    }
+}
@@ -0,0 +1,36 @@
+#include "core/data_type.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Logger, RuntimeLevel)
+    {
+        LogLevel saved = get_log_level();
+        set_log_level(LogLevel::Warn);
+        EXPECT_FALSE(log_enabled(LogLevel::Info));
+        EXPECT_TRUE(log_enabled(LogLevel::Error));
+
+        // Messages below the runtime level are not even formatted.
+        int evaluated = 0;
+        auto count = [&]()
+        { return ++evaluated; };
+        IT_LOG_INFO("skipped " << count());
+        EXPECT_EQ(evaluated, 0);
+        IT_LOG_WARN("logged " << count());
+        EXPECT_EQ(evaluated, 1);
+
+        set_log_level(LogLevel::Off);
+        EXPECT_FALSE(log_enabled(LogLevel::Error));
+        set_log_level(saved);
+    }
+
+    TEST(Logger, CompileLevel)
+    {
+        // Trace messages are compiled out unless explicitly requested.
+        LogLevel saved = get_log_level();
+        set_log_level(LogLevel::Trace);
+        EXPECT_EQ(log_enabled(LogLevel::Trace), IT_LOG_COMPILE_LEVEL == 0);
+        set_log_level(saved);
+    }
+}
@@ -0,0 +1,77 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/memory_planner.h"
+#include "core/runtime.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    // Every pair of buffers that are live at the same step must not overlap.
+    static void checkPlan(const vector<MemoryPlanner::Buffer> &buffers,
+                          const MemoryPlanner::Plan &plan)
+    {
+        for (size_t i = 0; i < buffers.size(); ++i)
+        {
+            EXPECT_LE(plan.offsets[i] + buffers[i].bytes, plan.peak);
+            for (size_t j = 0; j < i; ++j)
+            {
+                bool liveTogether = buffers[i].firstDef <= buffers[j].lastUse &&
+                                    buffers[j].firstDef <= buffers[i].lastUse;
+                bool overlap =
+                    plan.offsets[i] < plan.offsets[j] + buffers[j].bytes &&
+                    plan.offsets[j] < plan.offsets[i] + buffers[i].bytes;
+                EXPECT_FALSE(liveTogether && overlap) << i << " and " << j;
+            }
+        }
+    }
+
+    TEST(MemoryPlanner, Strategies)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        MemoryPlanner planner(runtime, sizeof(uint64_t));
+        // A small buffer released early would leave a hole below the large
+        // one in execution order; placing by size avoids it.
+        vector<MemoryPlanner::Buffer> buffers = {
+            {64, 0, 0}, {256, 0, 2}, {320, 1, 2}, {64, 2, 3}, {128, 3, 3}};
+        for (auto strategy :
+             {MemoryPlanner::Strategy::Sequential, MemoryPlanner::Strategy::BySize,
+              MemoryPlanner::Strategy::ByLifetime})
+        {
+            auto plan = planner.plan(buffers, strategy);
+            EXPECT_EQ(plan.strategy, strategy);
+            checkPlan(buffers, plan);
+        }
+        auto best = planner.plan(buffers);
+        checkPlan(buffers, best);
+        EXPECT_EQ(best.peak, 640u);
+    }
+
+    TEST(MemoryPlanner, DataMallocReusesIntermediates)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        const int depth = 16;
+        Tensor x = g->addTensor({1024}, DataType::Float32);
+        Tensor t = x;
+        for (int i = 0; i < depth; ++i)
+            t = g->addOp<ReluObj>(t, nullptr)->getOutput();
+        g->dataMalloc();
+
+        // The input is kept for the whole run; every Relu after the first
+        // overwrites its input, so the chain runs in the output's buffer.
+        std::set<void *> addresses;
+        for (auto &tensor : g->getTensors())
+            addresses.insert(tensor->getRawDataPtr<void *>());
+        EXPECT_EQ(addresses.size(), 2u);
+        EXPECT_NE(x->getRawDataPtr<void *>(), t->getRawDataPtr<void *>());
+
+        x->setData(IncrementalGenerator());
+        runtime->run(g);
+        vector<float> ans(1024);
+        for (size_t i = 0; i < ans.size(); ++i)
+            ans[i] = float(i);
+        EXPECT_TRUE(t->equalData(ans));
+    }
+}
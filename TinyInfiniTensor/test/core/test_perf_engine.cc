@@ -0,0 +1,79 @@
+#include "core/graph.h"
+#include "core/perf_engine.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "utils/thread_pool.h"
+
+#include "test.h"
+#include <cstdio>
+#include <fstream>
+
+namespace infini
+{
+    TEST(PerfEngine, TuneOnce)
+    {
+        auto &engine = PerfEngine::getInstance();
+        engine.clear();
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({40, 300}, DataType::Float32);
+        auto b = g->addTensor({300, 600}, DataType::Float32);
+        auto op = g->addOp<MatmulObj>(a, b, nullptr);
+        g->dataMalloc();
+        a->setData(OneGenerator());
+        b->setData(OneGenerator());
+
+        // Building the plan tunes the matmul; the result is then reused.
+        runtime->run(g);
+        EXPECT_EQ(engine.size(), 1u);
+        EXPECT_TRUE(op->getOutput()->equalData(vector<float>(40 * 600, 300)));
+
+        // A recorded configuration that is a candidate is used as is.
+        auto kernel = dynamic_cast<const TunableKernel *>(
+            KernelRegistry::getInstance().getKernel(
+                {Device::CPU, OpType::MatMul}));
+        ASSERT_NE(kernel, nullptr);
+        auto configs = kernel->getTuneConfigs(op);
+        ASSERT_GT(configs.size(), 1u);
+        auto key = kernel->getTuneKey(op) + "/threads=" +
+                   std::to_string(ThreadPool::getInstance().numThreads());
+        engine.setRecord(key, {configs.back(), 1.0});
+        EXPECT_EQ(engine.getConfig(*kernel, op, runtime.get()), configs.back());
+        // A stale one is tuned again.
+        engine.setRecord(key, {{1, 2, 3}, 1.0});
+        EXPECT_NE(engine.getConfig(*kernel, op, runtime.get()),
+                  TuneConfig({1, 2, 3}));
+        engine.clear();
+    }
+
+    TEST(PerfEngine, SaveAndLoad)
+    {
+        auto &engine = PerfEngine::getInstance();
+        engine.clear();
+        engine.setRecord("MatMul/test", {{32, 128, 256}, 0.5});
+        engine.setRecord("Transpose/test", {{16}, 0.25});
+        string path = testing::TempDir() + "perf_engine_test.json";
+        ASSERT_TRUE(engine.save(path));
+
+        engine.clear();
+        EXPECT_EQ(engine.size(), 0u);
+        ASSERT_TRUE(engine.load(path));
+        EXPECT_EQ(engine.size(), 2u);
+        auto record = engine.getRecord("MatMul/test");
+        ASSERT_TRUE(record.has_value());
+        EXPECT_EQ(record->config, TuneConfig({32, 128, 256}));
+        EXPECT_DOUBLE_EQ(record->time, 0.5);
+        EXPECT_FALSE(engine.getRecord("Unknown").has_value());
+
+        // Unreadable files are rejected without touching the records.
+        {
+            std::ofstream file(path);
+            file << "not json";
+        }
+        EXPECT_FALSE(engine.load(path));
+        EXPECT_EQ(engine.size(), 2u);
+        std::remove(path.c_str());
+        EXPECT_FALSE(engine.load(path));
+        engine.clear();
+    }
+} // namespace infini
@@ -0,0 +1,201 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+#include "utils/thread_pool.h"
+
+#include "test.h"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+namespace infini
+{
+    // The shared pool is sized on first use; make sure these tests exercise
+    // several threads even on a single-core machine.
+    static const int forceThreads = setenv("INFINI_NUM_THREADS", "4", 0);
+
+    TEST(ThreadPool, ParallelFor)
+    {
+        size_t n = 1000;
+        vector<std::atomic<int>> visits(n);
+        parallel_for(n, [&](size_t first, size_t last)
+                     {
+                         EXPECT_LT(first, last);
+                         for (size_t i = first; i < last; ++i)
+                             visits[i].fetch_add(1);
+                     });
+        for (auto &count : visits)
+            EXPECT_EQ(count.load(), 1);
+        parallel_for(0, [](size_t, size_t)
+                     { FAIL(); });
+    }
+
+    TEST(ThreadPool, NestedWait)
+    {
+        // Tasks wait for their own subtasks; waiting threads keep running
+        // queued work, so this cannot deadlock even with two threads.
+        ThreadPool pool(2);
+        std::atomic<int> done{0};
+        ThreadPool::TaskGroup outer;
+        for (int i = 0; i < 8; ++i)
+            pool.submit(outer, [&]
+                        {
+                            ThreadPool::TaskGroup inner;
+                            for (int j = 0; j < 8; ++j)
+                                pool.submit(inner, [&]
+                                            { done.fetch_add(1); });
+                            pool.wait(inner);
+                        });
+        pool.wait(outer);
+        EXPECT_EQ(done.load(), 64);
+    }
+
+    TEST(ThreadPool, Exception)
+    {
+        ThreadPool pool(4);
+        std::atomic<int> done{0};
+        ThreadPool::TaskGroup group;
+        for (int i = 0; i < 16; ++i)
+            pool.submit(group, [&, i]
+                        {
+                            if (i == 5)
+                                throw std::runtime_error("task failed");
+                            done.fetch_add(1);
+                        });
+        EXPECT_THROW(pool.wait(group), std::runtime_error);
+        EXPECT_EQ(done.load(), 15);
+    }
+
+    TEST(ThreadPool, WavefrontRun)
+    {
+        // Independent branches run concurrently while the memory plan reuses
+        // intermediate buffers across them.
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        int nBranches = 8;
+        auto x = g->addTensor(Shape{64, 64}, DataType::Float32);
+        TensorVec branches, biases;
+        for (int i = 0; i < nBranches; ++i)
+        {
+            auto bias = g->addTensor(Shape{1}, DataType::Float32);
+            auto a = g->addOp<ReluObj>(x, nullptr)->getOutput();
+            auto b = g->addOp<AddObj>(a, bias, nullptr)->getOutput();
+            auto c = g->addOp<ReluObj>(b, nullptr)->getOutput();
+            auto d = g->addOp<AddObj>(c, c, nullptr)->getOutput();
+            biases.emplace_back(bias);
+            branches.emplace_back(d);
+        }
+        auto y = g->addOp<ConcatObj>(branches, nullptr, 0)->getOutput();
+        g->dataMalloc();
+        x->setData(IncrementalGenerator());
+        for (int i = 0; i < nBranches; ++i)
+            biases[i]->setData([i](void *ptr, size_t size, DataType)
+                               { *static_cast<float *>(ptr) = float(i); });
+
+        vector<float> ans;
+        for (int i = 0; i < nBranches; ++i)
+            for (int v = 0; v < 64 * 64; ++v)
+                ans.emplace_back(2.f * (v + i));
+        for (int iter = 0; iter < 20; ++iter)
+        {
+            runtime->run(g);
+            EXPECT_TRUE(y->equalData(ans));
+        }
+    }
+
+    TEST(ThreadPool, RandomDagRun)
+    {
+        // Random DAGs of MatMul and Add, checked against a reference
+        // computed in double. Memory reused across branches must not let
+        // concurrently running operators overwrite each other's tensors.
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        int n = 8, nInputs = 3, nOps = 16;
+        using Matrix = vector<double>;
+        auto matmul = [n](const Matrix &a, const Matrix &b)
+        {
+            Matrix c(n * n);
+            for (int i = 0; i < n; ++i)
+                for (int k = 0; k < n; ++k)
+                    for (int j = 0; j < n; ++j)
+                        c[i * n + j] += a[i * n + k] * b[k * n + j];
+            return c;
+        };
+        for (unsigned seed = 0; seed < 200; ++seed)
+        {
+            std::mt19937 rng(seed);
+            Graph g = make_ref<GraphObj>(runtime);
+            TensorVec tensors;
+            // Reference values, and bounds on their magnitude to scale the
+            // rounding error by.
+            vector<Matrix> values, bounds;
+            for (int i = 0; i < nInputs; ++i)
+            {
+                tensors.emplace_back(
+                    g->addTensor(Shape{n, n}, DataType::Float32));
+                Matrix value(n * n), bound(n * n);
+                for (int j = 0; j < n * n; ++j)
+                {
+                    value[j] = int(rng() % 5) - 2;
+                    bound[j] = std::fabs(value[j]);
+                }
+                values.emplace_back(value);
+                bounds.emplace_back(bound);
+            }
+            for (int i = 0; i < nOps; ++i)
+            {
+                size_t a = rng() % tensors.size(), b = rng() % tensors.size();
+                if (rng() % 2)
+                {
+                    tensors.emplace_back(
+                        g->addOp<MatmulObj>(tensors[a], tensors[b], nullptr)
+                            ->getOutput());
+                    values.emplace_back(matmul(values[a], values[b]));
+                    bounds.emplace_back(matmul(bounds[a], bounds[b]));
+                }
+                else
+                {
+                    tensors.emplace_back(
+                        g->addOp<AddObj>(tensors[a], tensors[b], nullptr)
+                            ->getOutput());
+                    Matrix value(n * n), bound(n * n);
+                    for (int j = 0; j < n * n; ++j)
+                    {
+                        value[j] = values[a][j] + values[b][j];
+                        bound[j] = bounds[a][j] + bounds[b][j];
+                    }
+                    values.emplace_back(value);
+                    bounds.emplace_back(bound);
+                }
+            }
+            g->dataMalloc();
+            for (int i = 0; i < nInputs; ++i)
+                tensors[i]->setData([&](void *ptr, size_t, DataType)
+                                    {
+                                        std::copy(values[i].begin(),
+                                                  values[i].end(),
+                                                  static_cast<float *>(ptr));
+                                    });
+
+            for (int iter = 0; iter < 3; ++iter)
+            {
+                runtime->run(g);
+                for (size_t i = nInputs; i < tensors.size(); ++i)
+                {
+                    if (!tensors[i]->getTargets().empty())
+                        continue;
+                    auto out = tensors[i]->getRawDataPtr<float *>();
+                    int nWrong = 0;
+                    for (int j = 0; j < n * n; ++j)
+                        nWrong += std::fabs(out[j] - values[i][j]) >
+                                  1e-5 * (bounds[i][j] + 1);
+                    EXPECT_EQ(nWrong, 0) << "seed " << seed << ", tensor "
+                                         << i << ", run " << iter;
+                }
+            }
+        }
+    }
+} // namespace infini
+
@@ -0,0 +1,114 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cmath>
+#include <limits>
+
+namespace infini {
+
+// Runs a single Cast of `input` and compares its output with `expect`.
+template <typename From, typename To>
+static void testCast(CastType type, DataType inType, DataType outType,
+                     const vector<From> &input, const vector<To> &expect) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto i = g->addTensor({(int)input.size()}, inType);
+    auto op = g->addOp<CastObj>(i, nullptr, type);
+    g->dataMalloc();
+    i->setData([&](void *ptr, size_t size, DataType) {
+        std::copy(input.begin(), input.end(), static_cast<From *>(ptr));
+    });
+    runtime->run(g);
+    EXPECT_EQ(op->getOutput()->getDType(), outType);
+    EXPECT_TRUE(op->getOutput()->equalData(expect));
+}
+
+TEST(Cast, FloatToInt) {
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    float inf = std::numeric_limits<float>::infinity();
+    // Truncation toward zero, saturation and NaN as 0, with enough elements
+    // for the vector loop and a tail.
+    vector<float> input{1.5f,  -1.5f, 2.9f, -2.9f, 3e9f, -3e9f, nan,
+                        inf,   -inf,  0.f,  7.f,   -7.f,  2147483520.f};
+    testCast(CastType::Float2Int32, DataType::Float32, DataType::Int32, input,
+             vector<int32_t>{1, -1, 2, -2, INT32_MAX, INT32_MIN, 0, INT32_MAX,
+                             INT32_MIN, 0, 7, -7, 2147483520});
+    testCast(CastType::Float2Int8, DataType::Float32, DataType::Int8, input,
+             vector<int8_t>{1, -1, 2, -2, 127, -128, 0, 127, -128, 0, 7, -7,
+                            127});
+    testCast(CastType::Float2Int64, DataType::Float32, DataType::Int64, input,
+             vector<int64_t>{1, -1, 2, -2, 3000000000, -3000000000, 0,
+                             INT64_MAX, INT64_MIN, 0, 7, -7, 2147483520});
+}
+
+TEST(Cast, IntToInt) {
+    // Narrowing keeps the low bits.
+    testCast(CastType::Int642Int32, DataType::Int64, DataType::Int32,
+             vector<int64_t>{1, -1, 0x100000005, -0x100000000},
+             vector<int32_t>{1, -1, 5, 0});
+    testCast(CastType::Int642Uint32, DataType::Int64, DataType::UInt32,
+             vector<int64_t>{1, -1, 0x100000005},
+             vector<uint32_t>{1, 0xffffffff, 5});
+    testCast(CastType::Int322Int8, DataType::Int32, DataType::Int8,
+             vector<int32_t>{127, 128, -129, 300},
+             vector<int8_t>{127, -128, 127, 44});
+    testCast(CastType::Uint82Int64, DataType::UInt8, DataType::Int64,
+             vector<uint8_t>{0, 200, 255}, vector<int64_t>{0, 200, 255});
+}
+
+TEST(Cast, Float16) {
+    // Exact values, ties to even, overflow to infinity and a subnormal.
+    vector<float> values{1.f,   -2.f,           0.5f,           65504.f,
+                         65520.f, 1e-7f,        1.f + 0x1p-11f, 1.f + 0x3p-11f,
+                         -0.f,  3.f,            -65536.f,       0.1f};
+    vector<uint16_t> halves{0x3c00, 0xc000, 0x3800, 0x7bff, 0x7c00, 0x0002,
+                            0x3c00, 0x3c02, 0x8000, 0x4200, 0xfc00, 0x2e66};
+    testCast(CastType::Float2Float16, DataType::Float32, DataType::Float16,
+             values, halves);
+    testCast(CastType::Float162Float, DataType::Float16, DataType::Float32,
+             halves,
+             vector<float>{1.f, -2.f, 0.5f, 65504.f, INFINITY, 0x2p-24f, 1.f,
+                           1.f + 0x2p-10f, -0.f, 3.f, -INFINITY,
+                           0.0999755859375f});
+}
+
+TEST(Cast, BFloat16) {
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    testCast(CastType::Float2BFloat16, DataType::Float32, DataType::BFloat16,
+             vector<float>{1.f, -2.f, 1.f + 0x1p-8f, 1.f + 0x3p-8f, 3e38f, nan,
+                           0.f, 1.f + 0x1p-7f, 100.f, -0.5f},
+             vector<uint16_t>{0x3f80, 0xc000, 0x3f80, 0x3f82, 0x7f62, 0x7fc0,
+                              0x0000, 0x3f81, 0x42c8, 0xbf00});
+    testCast(CastType::BFloat162Float, DataType::BFloat16, DataType::Float32,
+             vector<uint16_t>{0x3f80, 0xc000, 0x3f81, 0x42c8},
+             vector<float>{1.f, -2.f, 1.f + 0x1p-7f, 100.f});
+}
+
+TEST(Cast, ToFloat) {
+    testCast(CastType::Int322Float, DataType::Int32, DataType::Float32,
+             vector<int32_t>{0, -3, 16777217, INT32_MAX, 5, 6, 7, 8, 9},
+             vector<float>{0, -3, 16777216, 2147483648.f, 5, 6, 7, 8, 9});
+    testCast(CastType::Uint82Float, DataType::UInt8, DataType::Float32,
+             vector<uint8_t>{0, 255}, vector<float>{0, 255});
+    testCast(CastType::Int642Float, DataType::Int64, DataType::Float32,
+             vector<int64_t>{-1, int64_t(1) << 40}, vector<float>{-1, 0x1p40f});
+}
+
+TEST(Cast, LargeRoundTrip) {
+    // Spans several tasks of the parallel loop.
+    constexpr size_t n = 100003;
+    vector<float> floats(n);
+    vector<int32_t> ints(n);
+    for (size_t i = 0; i < n; ++i) {
+        ints[i] = int32_t(i) - 50000;
+        floats[i] = float(ints[i]);
+    }
+    testCast(CastType::Float2Int32, DataType::Float32, DataType::Int32, floats,
+             ints);
+    testCast(CastType::Int322Float, DataType::Int32, DataType::Float32, ints,
+             floats);
+}
+
+} // namespace infini
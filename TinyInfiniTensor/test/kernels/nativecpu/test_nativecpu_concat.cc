@@ -24,4 +24,43 @@ TEST(Concat, NativeCpu) {
                       6, 7, 8, 1, 1, 1, 9, 10, 11, 1, 1, 1}));
 }
 
+TEST(Concat, NativeCpuHalf) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto t1 = g->addTensor({2, 3}, DataType::BFloat16);
+    auto t2 = g->addTensor({2, 1}, DataType::BFloat16);
+    auto op = g->addOp<ConcatObj>(TensorVec{t1, t2}, nullptr, 1);
+    g->dataMalloc();
+    t1->setData(IncrementalGenerator());
+    t2->setData(OneGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(
+        roundToHalf({0, 1, 2, 1, 3, 4, 5, 1}, DataType::BFloat16)));
+}
+
+TEST(Concat, NativeCpuLargeBlocks) {
+    // Rows longer than a task and an output large enough for streaming
+    // stores.
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    const int rows = 4, n1 = 300000, n2 = 250007;
+    auto t1 = g->addTensor({rows, n1}, DataType::Float32);
+    auto t2 = g->addTensor({rows, n2}, DataType::Float32);
+    auto op = g->addOp<ConcatObj>(TensorVec{t1, t2}, nullptr, 1);
+    g->dataMalloc();
+    t1->setData(IncrementalGenerator());
+    t2->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    vector<float> ans;
+    for (int r = 0; r < rows; ++r) {
+        for (int i = 0; i < n1; ++i)
+            ans.emplace_back(r * n1 + i);
+        for (int i = 0; i < n2; ++i)
+            ans.emplace_back(r * n2 + i);
+    }
+    EXPECT_TRUE(op->getOutput()->equalData(ans));
+}
+
 } // namespace infini
@@ -11,11 +11,12 @@ template <class T>
 void testElementWiseNativeCpu(
     const std::function<void(void *, size_t, DataType)> &generator1,
     const std::function<void(void *, size_t, DataType)> &generator2,
-    const Shape &shape1, const Shape &shape2, const ExpectOutput &ansVec) {
+    const Shape &shape1, const Shape &shape2, const ExpectOutput &ansVec,
+    DataType dtype = DataType::Float32) {
     Runtime runtime = NativeCpuRuntimeObj::getInstance();
     Graph g = make_ref<GraphObj>(runtime);
-    auto t1 = g->addTensor(shape1, DataType::Float32);
-    auto t2 = g->addTensor(shape2, DataType::Float32);
+    auto t1 = g->addTensor(shape1, dtype);
+    auto t2 = g->addTensor(shape2, dtype);
 
     auto op = g->addOp<T>(t1, t2, nullptr);
     g->dataMalloc();
@@ -23,7 +24,10 @@ void testElementWiseNativeCpu(
     t2->setData(generator2);
 
     runtime->run(g);
-    EXPECT_TRUE(op->getOutput()->equalData(ansVec));
+    if (dtype == DataType::Float32)
+        EXPECT_TRUE(op->getOutput()->equalData(ansVec));
+    else
+        EXPECT_TRUE(op->getOutput()->equalData(roundToHalf(ansVec, dtype)));
 }
 
 TEST(ElementWise, NativeCpu) {
@@ -41,4 +45,59 @@ TEST(ElementWise, NativeCpu) {
         Shape{2, 1, 1}, ExpectOutput{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
 }
 
+TEST(ElementWise, NativeCpuBroadcast) {
+    // Same shape: contiguous fast path.
+    testElementWiseNativeCpu<AddObj>(IncrementalGenerator(),
+                                     IncrementalGenerator(), Shape{2, 3},
+                                     Shape{2, 3},
+                                     ExpectOutput{0, 2, 4, 6, 8, 10});
+    // Scalar and trailing-dim broadcast.
+    testElementWiseNativeCpu<AddObj>(IncrementalGenerator(), OneGenerator(),
+                                     Shape{2, 2}, Shape{},
+                                     ExpectOutput{1, 2, 3, 4});
+    testElementWiseNativeCpu<AddObj>(IncrementalGenerator(),
+                                     IncrementalGenerator(), Shape{2, 3},
+                                     Shape{3}, ExpectOutput{0, 2, 4, 3, 5, 7});
+    // Both inputs broadcast, in different dimensions.
+    testElementWiseNativeCpu<AddObj>(
+        IncrementalGenerator(), IncrementalGenerator(), Shape{2, 1, 3},
+        Shape{1, 2, 1}, ExpectOutput{0, 1, 2, 1, 2, 3, 3, 4, 5, 4, 5, 6});
+    testElementWiseNativeCpu<SubObj>(
+        IncrementalGenerator(), IncrementalGenerator(), Shape{3, 1},
+        Shape{1, 4}, ExpectOutput{0, -1, -2, -3, 1, 0, -1, -2, 2, 1, 0, -1});
+}
+
+TEST(ElementWise, NativeCpuHalf) {
+    for (auto dtype : {DataType::Float16, DataType::BFloat16}) {
+        SCOPED_TRACE(dtype.toString());
+        testElementWiseNativeCpu<AddObj>(
+            IncrementalGenerator(), IncrementalGenerator(), Shape{2, 1, 3},
+            Shape{1, 2, 1}, ExpectOutput{0, 1, 2, 1, 2, 3, 3, 4, 5, 4, 5, 6},
+            dtype);
+        // Computed in float and rounded once.
+        testElementWiseNativeCpu<DivObj>(
+            OneGenerator(), IncrementalGenerator(), Shape{1}, Shape{5},
+            ExpectOutput{INFINITY, 1.f, 1.f / 2, 1.f / 3, 1.f / 4}, dtype);
+        // Rows longer than a conversion block.
+        vector<float> ans(600);
+        for (size_t i = 0; i < ans.size(); ++i)
+            ans[i] = float(i % 300 % 128) * (i < 300 ? 3.f : -3.f);
+        testElementWiseNativeCpu<MulObj>(
+            [](void *ptr, size_t size, DataType dtype) {
+                vector<float> values(size);
+                for (size_t i = 0; i < size; ++i)
+                    values[i] = float(i % 300 % 128);
+                auto bits = roundToHalf(values, dtype);
+                std::copy(bits.begin(), bits.end(),
+                          static_cast<uint16_t *>(ptr));
+            },
+            [](void *ptr, size_t size, DataType dtype) {
+                auto bits = roundToHalf({3.f, -3.f}, dtype);
+                std::copy(bits.begin(), bits.end(),
+                          static_cast<uint16_t *>(ptr));
+            },
+            Shape{2, 300}, Shape{2, 1}, ans, dtype);
+    }
+}
+
 } // namespace infini
@@ -0,0 +1,106 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/fused_element_wise.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini {
+
+// Builds the same chain twice, runs one graph as is and the other after
+// optimize(), and compares the outputs.
+template <typename Build>
+static void testFusedNativeCpu(Build &&build, const vector<Shape> &inputShapes,
+                               DataType dtype, size_t expectedOps) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    auto generator = [](void *ptr, size_t size, DataType dtype) {
+        for (size_t i = 0; i < size; ++i) {
+            if (dtype == DataType::Float32)
+                reinterpret_cast<float *>(ptr)[i] = float(i % 13) - 6.5f;
+            else
+                reinterpret_cast<uint32_t *>(ptr)[i] = uint32_t(i % 11 + 1);
+        }
+    };
+    // The graphs own the memory of their tensors.
+    vector<Graph> graphs;
+    vector<Tensor> outputs;
+    for (bool optimize : {false, true}) {
+        Graph g = graphs.emplace_back(make_ref<GraphObj>(runtime));
+        TensorVec inputs;
+        for (auto &shape : inputShapes)
+            inputs.emplace_back(g->addTensor(shape, dtype));
+        Tensor out = build(g, inputs);
+        if (optimize) {
+            g->optimize();
+            EXPECT_EQ(g->getOperators().size(), expectedOps);
+            EXPECT_EQ(g->getOperators().back()->getOpType(),
+                      OpType::FusedElementWise);
+        }
+        g->dataMalloc();
+        for (auto &input : inputs)
+            input->setData(generator);
+        runtime->run(g);
+        outputs.emplace_back(out);
+    }
+    EXPECT_TRUE(outputs[0]->equalData(outputs[1]));
+}
+
+TEST(FusedElementWise, NativeCpuChain) {
+    // Add -> Relu -> Clip -> Mul, with broadcast inputs at both ends
+    auto build = [](Graph g, const TensorVec &in) {
+        auto t = g->addOp<AddObj>(in[0], in[1], nullptr)->getOutput();
+        t = g->addOp<ReluObj>(t, nullptr)->getOutput();
+        t = g->addOp<ClipObj>(t, nullptr, 0.5f, 4.0f)->getOutput();
+        return g->addOp<MulObj>(in[2], t, nullptr)->getOutput();
+    };
+    testFusedNativeCpu(build, {{3, 1000}, {1000}, {3, 1}}, DataType::Float32,
+                       1);
+    testFusedNativeCpu(build, {{2, 3, 40000}, {1, 3, 1}, {40000}},
+                       DataType::Float32, 1);
+    testFusedNativeCpu(build, {{2, 5, 7}, {5, 1}, {7}}, DataType::UInt32, 1);
+}
+
+TEST(FusedElementWise, NativeCpuSharedOperands) {
+    // x * x + Relu(x), and an intermediate with another reader stays
+    auto build = [](Graph g, const TensorVec &in) {
+        auto sq = g->addOp<MulObj>(in[0], in[0], nullptr)->getOutput();
+        auto r = g->addOp<ReluObj>(in[0], nullptr)->getOutput();
+        auto sum = g->addOp<AddObj>(sq, r, nullptr)->getOutput();
+        auto scaled = g->addOp<MulObj>(sum, in[1], nullptr)->getOutput();
+        auto shifted = g->addOp<SubObj>(scaled, sum, nullptr)->getOutput();
+        return g->addOp<DivObj>(shifted, in[1], nullptr)->getOutput();
+    };
+    // Once scaled and shifted are merged, sum has a single reader again
+    testFusedNativeCpu(build, {{4, 9}, {9}}, DataType::Float32, 1);
+}
+
+TEST(FusedElementWise, NativeCpuCast) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor({6, 7}, DataType::Float32);
+    auto b = g->addTensor({7}, DataType::Float32);
+    auto t = g->addOp<AddObj>(a, b, nullptr)->getOutput();
+    t = g->addOp<CastObj>(t, nullptr, CastType::Float2Int32)->getOutput();
+    auto o = g->addOp<CastObj>(t, nullptr, CastType::Int322Float)->getOutput();
+    g->optimize();
+    EXPECT_EQ(g->getOperators().size(), 1u);
+    g->dataMalloc();
+    auto generator = [](void *ptr, size_t size, DataType) {
+        for (size_t i = 0; i < size; ++i)
+            reinterpret_cast<float *>(ptr)[i] = float(i % 13) * 0.7f - 4.f;
+    };
+    a->setData(generator);
+    b->setData(generator);
+    runtime->run(g);
+
+    // Float to Int32 truncates toward zero
+    vector<float> ans(6 * 7);
+    for (size_t i = 0; i < ans.size(); ++i)
+        ans[i] = std::trunc((float(i % 13) * 0.7f - 4.f) +
+                            (float(i % 7 % 13) * 0.7f - 4.f));
+    EXPECT_TRUE(o->equalData(ans));
+}
+
+} // namespace infini
@@ -0,0 +1,139 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+
+#include "test.h"
+
+namespace infini {
+
+// Straightforward triple loop used as the reference for the blocked kernel.
+// Inputs are generated incrementally and shrunk to keep float sums exact.
+static vector<float> matmulReference(const Shape &dimA, const Shape &dimB,
+                                     const Shape &dimC, bool transA,
+                                     bool transB) {
+    auto value = [](size_t i) { return float(i % 7) - 3.f; };
+    int rankA = dimA.size(), rankB = dimB.size(), rankC = dimC.size();
+    int m = dimC[rankC - 2], n = dimC[rankC - 1];
+    int k = transA ? dimA[rankA - 2] : dimA[rankA - 1];
+    size_t batch = 1;
+    for (int i = 0; i < rankC - 2; ++i)
+        batch *= dimC[i];
+
+    vector<float> ans(batch * m * n);
+    for (size_t b = 0; b < batch; ++b) {
+        // Map the output batch index back to each (broadcast) input batch.
+        size_t offA = 0, offB = 0, strideA = 1, strideB = 1, rest = b;
+        for (int i = rankC - 3; i >= 0; --i) {
+            size_t idx = rest % dimC[i];
+            rest /= dimC[i];
+            int ia = i - (rankC - rankA), ib = i - (rankC - rankB);
+            if (ia >= 0) {
+                offA += (dimA[ia] == 1 ? 0 : idx) * strideA;
+                strideA *= dimA[ia];
+            }
+            if (ib >= 0) {
+                offB += (dimB[ib] == 1 ? 0 : idx) * strideB;
+                strideB *= dimB[ib];
+            }
+        }
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < n; ++j) {
+                float sum = 0;
+                for (int p = 0; p < k; ++p) {
+                    size_t a = transA ? p * m + i : i * k + p;
+                    size_t bb = transB ? j * k + p : p * n + j;
+                    sum += value(offA * m * k + a) * value(offB * k * n + bb);
+                }
+                ans[(b * m + i) * n + j] = sum;
+            }
+    }
+    return ans;
+}
+
+static void testMatmulNativeCpu(const Shape &dimA, const Shape &dimB,
+                                bool transA, bool transB,
+                                DataType dtype = DataType::Float32) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor(dimA, dtype);
+    auto B = g->addTensor(dimB, dtype);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr, transA, transB);
+    g->dataMalloc();
+    auto generator = [](void *ptr, size_t size, DataType dtype) {
+        vector<float> data(size);
+        for (size_t i = 0; i < size; ++i)
+            data[i] = float(i % 7) - 3.f;
+        if (dtype == DataType::Float32)
+            std::copy(data.begin(), data.end(), static_cast<float *>(ptr));
+        else if (dtype == DataType::Int8)
+            std::copy(data.begin(), data.end(), static_cast<int8_t *>(ptr));
+        else {
+            auto bits = roundToHalf(data, dtype);
+            std::copy(bits.begin(), bits.end(), static_cast<uint16_t *>(ptr));
+        }
+    };
+    A->setData(generator);
+    B->setData(generator);
+
+    runtime->run(g);
+    auto C = op->getOutput();
+    auto ans = matmulReference(dimA, dimB, C->getDims(), transA, transB);
+    // Half precision accumulates in float, so the exact sums are rounded
+    // once. Int8 accumulates exactly into an Int32 output.
+    if (dtype == DataType::Float32)
+        EXPECT_TRUE(C->equalData(ans));
+    else if (dtype == DataType::Int8)
+        EXPECT_TRUE(C->equalData(vector<int32_t>(ans.begin(), ans.end())));
+    else
+        EXPECT_TRUE(C->equalData(roundToHalf(ans, dtype)));
+}
+
+TEST(Matmul, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor({1, 2, 3}, DataType::Float32);
+    auto B = g->addTensor({1, 3, 2}, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr);
+    g->dataMalloc();
+    A->setData(IncrementalGenerator());
+    B->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(vector<float>{10, 13, 28, 40}));
+}
+
+TEST(Matmul, NativeCpuTranspose) {
+    testMatmulNativeCpu({5, 3}, {5, 7}, true, false);
+    testMatmulNativeCpu({3, 5}, {7, 5}, false, true);
+    testMatmulNativeCpu({2, 5, 3}, {2, 7, 5}, true, true);
+}
+
+TEST(Matmul, NativeCpuBroadcast) {
+    testMatmulNativeCpu({2, 3, 4, 5}, {5, 6}, false, false);
+    testMatmulNativeCpu({1, 3, 4, 5}, {2, 1, 5, 6}, false, false);
+    testMatmulNativeCpu({3, 5, 4}, {2, 1, 6, 5}, true, true);
+}
+
+TEST(Matmul, NativeCpuBlocked) {
+    // Crosses the M, N and K cache blocks and the register tile edges.
+    testMatmulNativeCpu({67, 263}, {263, 517}, false, false);
+    testMatmulNativeCpu({263, 67}, {517, 263}, true, true);
+}
+
+TEST(Matmul, NativeCpuHalf) {
+    for (auto dtype : {DataType::Float16, DataType::BFloat16}) {
+        SCOPED_TRACE(dtype.toString());
+        testMatmulNativeCpu({2, 3, 4, 5}, {5, 6}, false, false, dtype);
+        testMatmulNativeCpu({3, 5, 4}, {2, 1, 6, 5}, true, true, dtype);
+        testMatmulNativeCpu({67, 263}, {263, 517}, false, false, dtype);
+    }
+}
+
+TEST(Matmul, NativeCpuInt8) {
+    testMatmulNativeCpu({2, 3, 4, 5}, {5, 6}, false, false, DataType::Int8);
+    testMatmulNativeCpu({3, 5, 4}, {2, 1, 6, 5}, true, true, DataType::Int8);
+    testMatmulNativeCpu({67, 263}, {263, 517}, false, false, DataType::Int8);
+}
+
+} // namespace infini
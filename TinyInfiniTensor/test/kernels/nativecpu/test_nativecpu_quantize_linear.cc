@@ -0,0 +1,134 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/quantize_linear.h"
+
+#include "test.h"
+#include <cmath>
+#include <limits>
+
+namespace infini {
+
+TEST(QuantizeLinear, NativeCpuPerTensor) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    // Ties round to even, out of range values saturate and NaN maps to the
+    // zero point.
+    vector<float> input{0.f, 1.f, 1.5f, 2.5f, -2.5f, -3.f, 1e3f, -1e3f, nan};
+    auto i = g->addTensor({(int)input.size()}, DataType::Float32);
+    auto s8 = g->addOp<QuantizeLinearObj>(i, nullptr, QuantParams{{0.5f}, {1}});
+    auto u8 = g->addOp<QuantizeLinearObj>(
+        i, nullptr, QuantParams{{1.f}, {128}}, DataType::UInt8);
+    auto dq = g->addOp<DequantizeLinearObj>(s8->getOutput(), nullptr,
+                                            QuantParams{{0.5f}, {1}});
+    g->dataMalloc();
+    i->setData([&](void *ptr, size_t, DataType) {
+        std::copy(input.begin(), input.end(), static_cast<float *>(ptr));
+    });
+
+    runtime->run(g);
+    EXPECT_TRUE(s8->getOutput()->equalData(
+        vector<int8_t>{1, 3, 4, 6, -4, -5, 127, -128, 1}));
+    EXPECT_TRUE(u8->getOutput()->equalData(
+        vector<uint8_t>{128, 129, 130, 130, 126, 125, 255, 0, 128}));
+    EXPECT_TRUE(dq->getOutput()->equalData(
+        vector<float>{0, 1, 1.5, 2.5, -2.5, -3, 63, -64.5, 0}));
+}
+
+TEST(QuantizeLinear, NativeCpuSaturateWithZeroPoint) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    float inf = std::numeric_limits<float>::infinity();
+    // Values beyond the int32 range saturate before the zero point is added.
+    vector<float> input{inf, 3e9f, -3e9f, -inf, 200.f, -200.f};
+    auto i = g->addTensor({(int)input.size()}, DataType::Float32);
+    auto u8 = g->addOp<QuantizeLinearObj>(
+        i, nullptr, QuantParams{{1.f}, {128}}, DataType::UInt8);
+    auto s8 = g->addOp<QuantizeLinearObj>(i, nullptr, QuantParams{{1.f}, {5}});
+    auto s8n =
+        g->addOp<QuantizeLinearObj>(i, nullptr, QuantParams{{1.f}, {-5}});
+    g->dataMalloc();
+    i->setData([&](void *ptr, size_t, DataType) {
+        std::copy(input.begin(), input.end(), static_cast<float *>(ptr));
+    });
+
+    runtime->run(g);
+    EXPECT_TRUE(
+        u8->getOutput()->equalData(vector<uint8_t>{255, 255, 0, 0, 255, 0}));
+    EXPECT_TRUE(s8->getOutput()->equalData(
+        vector<int8_t>{127, 127, -128, -128, 127, -128}));
+    EXPECT_TRUE(s8n->getOutput()->equalData(
+        vector<int8_t>{127, 127, -128, -128, 127, -128}));
+}
+
+TEST(QuantizeLinear, NativeCpuPerChannel) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    // Large enough to be split across tasks in the middle of a channel.
+    Shape dims{2, 3, 20000};
+    QuantParams params{{0.5f, 1.f, 2.f}, {-1, 0, 1}, 1};
+    auto i = g->addTensor(dims, DataType::Float32);
+    auto q = g->addOp<QuantizeLinearObj>(i, nullptr, params);
+    auto dq = g->addOp<DequantizeLinearObj>(q->getOutput(), nullptr, params);
+    g->dataMalloc();
+    size_t n = i->size(), inner = dims[2];
+    auto value = [](size_t j) { return float(int(j % 64) - 32); };
+    i->setData([&](void *ptr, size_t, DataType) {
+        for (size_t j = 0; j < n; ++j)
+            static_cast<float *>(ptr)[j] = value(j);
+    });
+
+    runtime->run(g);
+    vector<int8_t> quantized(n);
+    vector<float> dequantized(n);
+    for (size_t j = 0; j < n; ++j) {
+        size_t c = j / inner % 3;
+        float scale = params.scales[c];
+        int zero = params.zeroPoints[c];
+        quantized[j] = int8_t(std::nearbyint(value(j) / scale) + zero);
+        dequantized[j] = float(quantized[j] - zero) * scale;
+    }
+    EXPECT_TRUE(q->getOutput()->equalData(quantized));
+    EXPECT_TRUE(dq->getOutput()->equalData(dequantized));
+}
+
+TEST(DequantizeLinear, NativeCpuInt32) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto i = g->addTensor({2, 2}, DataType::Int32);
+    auto dq = g->addOp<DequantizeLinearObj>(
+        i, nullptr, QuantParams{{0.25f, 4.f}, {0, 0}, -1});
+    g->dataMalloc();
+    i->setData([](void *ptr, size_t, DataType) {
+        int32_t values[] = {100000, -3, 7, 1 << 20};
+        std::copy(values, values + 4, static_cast<int32_t *>(ptr));
+    });
+
+    runtime->run(g);
+    EXPECT_TRUE(dq->getOutput()->equalData(
+        vector<float>{25000, -12, 1.75, 4194304}));
+}
+
+TEST(DequantizeLinear, NativeCpuInt32Extremes) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto i = g->addTensor({2}, DataType::Int32);
+    auto above = g->addOp<DequantizeLinearObj>(i, nullptr,
+                                               QuantParams{{1.f}, {1}});
+    auto below = g->addOp<DequantizeLinearObj>(i, nullptr,
+                                               QuantParams{{1.f}, {-1}});
+    g->dataMalloc();
+    i->setData([](void *ptr, size_t, DataType) {
+        static_cast<int32_t *>(ptr)[0] = std::numeric_limits<int32_t>::min();
+        static_cast<int32_t *>(ptr)[1] = std::numeric_limits<int32_t>::max();
+    });
+
+    // The differences leave the int32 range.
+    runtime->run(g);
+    EXPECT_TRUE(above->getOutput()->equalData(
+        vector<float>{-2147483649.f, 2147483646.f}));
+    EXPECT_TRUE(below->getOutput()->equalData(
+        vector<float>{-2147483647.f, 2147483648.f}));
+}
+
+} // namespace infini
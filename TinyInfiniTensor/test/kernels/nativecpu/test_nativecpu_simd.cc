@@ -0,0 +1,105 @@
+#include "core/data_type.h"
+#include "kernels/cpu/simd.h"
+
+#include "test.h"
+#include <cstring>
+#include <limits>
+
+namespace infini {
+
+template <typename T>
+static void checkSimdOps(const SimdOps<T> &ops, const SimdOps<T> &ref) {
+    // 37 elements exercise the full vectors of every ISA plus a tail.
+    constexpr size_t n = 37;
+    vector<T> a(n), b(n), out(n), expect(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = T(i * 3) - T(40);
+        b[i] = T(i % 5 + 1);
+    }
+    for (auto [kernel, refKernel] :
+         {std::pair{ops.add, ref.add}, std::pair{ops.sub, ref.sub},
+          std::pair{ops.mul, ref.mul}, std::pair{ops.div, ref.div}}) {
+        for (size_t sa : {0, 1})
+            for (size_t sb : {0, 1}) {
+                kernel(out.data(), a.data(), sa, b.data(), sb, n);
+                refKernel(expect.data(), a.data(), sa, b.data(), sb, n);
+                EXPECT_EQ(out, expect);
+            }
+    }
+    ops.relu(out.data(), a.data(), n);
+    ref.relu(expect.data(), a.data(), n);
+    EXPECT_EQ(out, expect);
+    ops.clip(out.data(), a.data(), n, T(3), T(20));
+    ref.clip(expect.data(), a.data(), n, T(3), T(20));
+    EXPECT_EQ(out, expect);
+}
+
+static void checkCastOps(const CastOps &ops, const CastOps &ref) {
+    // Bit patterns spread over every exponent, plus the special values.
+    constexpr size_t n = 1000;
+    vector<float> f(n);
+    vector<int32_t> i(n);
+    vector<uint16_t> h(n);
+    for (size_t k = 0; k < n; ++k) {
+        uint32_t bits = uint32_t(k * 2654435761u);
+        std::memcpy(&f[k], &bits, sizeof(bits));
+        i[k] = int32_t(bits);
+        h[k] = uint16_t(bits >> 7);
+    }
+    f[0] = std::numeric_limits<float>::infinity();
+    f[1] = -f[0];
+    f[2] = std::numeric_limits<float>::quiet_NaN();
+    f[3] = 0x1p31f;
+    f[4] = -0x1p31f;
+    f[5] = 65520.f;
+    auto check = [](auto kernel, auto refKernel, const auto &in, auto out) {
+        auto expect = out;
+        kernel(out.data(), in.data(), in.size());
+        refKernel(expect.data(), in.data(), in.size());
+        EXPECT_EQ(std::memcmp(out.data(), expect.data(),
+                              out.size() * sizeof(out[0])),
+                  0);
+    };
+    check(ops.f32ToI32, ref.f32ToI32, f, vector<int32_t>(n));
+    check(ops.i32ToF32, ref.i32ToF32, i, vector<float>(n));
+    check(ops.f32ToF16, ref.f32ToF16, f, vector<uint16_t>(n));
+    check(ops.f16ToF32, ref.f16ToF32, h, vector<float>(n));
+    check(ops.f32ToBf16, ref.f32ToBf16, f, vector<uint16_t>(n));
+    check(ops.bf16ToF32, ref.bf16ToF32, h, vector<float>(n));
+}
+
+TEST(Simd, MatchesScalar) {
+    const auto &scalar = get_simd_kernels_scalar();
+    for (auto isa : {CpuIsa::SSE41, CpuIsa::AVX2, CpuIsa::AVX512}) {
+        auto kernels = get_simd_kernels(isa);
+        if (!kernels)
+            continue;
+        SCOPED_TRACE(cpu_isa_name(isa));
+        EXPECT_EQ(kernels->isa, isa);
+        checkSimdOps(kernels->f32, scalar.f32);
+        checkSimdOps(kernels->u32, scalar.u32);
+        checkCastOps(kernels->cast, scalar.cast);
+
+        // A 21 x 19 block inside 23 x 29 storage covers full tiles and
+        // both edges.
+        constexpr size_t rows = 21, cols = 19, ldIn = 23, ldOut = 29;
+        vector<uint32_t> in(rows * ldIn), out(cols * ldOut, 0),
+            expect(cols * ldOut, 0);
+        for (size_t i = 0; i < in.size(); ++i)
+            in[i] = i;
+        kernels->transpose32(in.data(), ldIn, out.data(), ldOut, rows, cols);
+        scalar.transpose32(in.data(), ldIn, expect.data(), ldOut, rows, cols);
+        EXPECT_EQ(out, expect);
+
+        vector<uint16_t> in16(in.begin(), in.end()), out16(cols * ldOut, 0),
+            expect16(cols * ldOut, 0);
+        kernels->transpose16(in16.data(), ldIn, out16.data(), ldOut, rows,
+                             cols);
+        scalar.transpose16(in16.data(), ldIn, expect16.data(), ldOut, rows,
+                           cols);
+        EXPECT_EQ(out16, expect16);
+    }
+    EXPECT_LE(get_simd_kernels().isa, detect_cpu_isa());
+}
+
+} // namespace infini
@@ -24,4 +24,51 @@ TEST(Transpose, NativeCpu) {
                                                           8, 9, 10, 11, 20, 21, 22, 23}));
 }
 
+template <typename T>
+static void testTransposeNativeCpu(const Shape &inDim, const Shape &permute,
+                                   DataType dtype) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto input = g->addTensor(inDim, dtype);
+    auto op = g->addOp<TransposeObj>(input, nullptr, permute);
+    g->dataMalloc();
+    input->setData(IncrementalGenerator());
+    runtime->run(g);
+
+    // Reference: scatter every input element to its permuted position.
+    size_t rank = inDim.size(), n = input->size();
+    vector<T> expect(n);
+    for (size_t i = 0; i < n; ++i) {
+        Shape pos(rank);
+        for (size_t d = rank, rest = i; d-- > 0; rest /= inDim[d])
+            pos[d] = rest % inDim[d];
+        size_t o = 0;
+        for (size_t j = 0; j < rank; ++j)
+            o = o * inDim[permute[j]] + pos[permute[j]];
+        if constexpr (std::is_same_v<T, uint16_t>)
+            expect[o] = float_to_half(float(i));
+        else
+            expect[o] = T(i);
+    }
+    EXPECT_TRUE(op->getOutput()->equalData(expect));
+}
+
+TEST(Transpose, NativeCpuPermutations) {
+    // 2-D tile transposes with edges, batched or after merging dims.
+    testTransposeNativeCpu<float>({37, 53}, {1, 0}, DataType::Float32);
+    testTransposeNativeCpu<float>({3, 70, 19}, {0, 2, 1}, DataType::Float32);
+    testTransposeNativeCpu<float>({4, 5, 130}, {2, 0, 1}, DataType::Float32);
+    testTransposeNativeCpu<uint32_t>({2, 1, 3, 9, 5}, {4, 2, 1, 0, 3},
+                                     DataType::UInt32);
+    // 16-bit tiles, on Float16 values small enough to be exact.
+    testTransposeNativeCpu<uint16_t>({2, 19, 29}, {0, 2, 1},
+                                     DataType::Float16);
+    // Innermost dim kept in place: row copies.
+    testTransposeNativeCpu<float>({6, 1, 7, 5}, {2, 0, 1, 3},
+                                  DataType::Float32);
+    // Identity after dropping extent-1 dims.
+    testTransposeNativeCpu<float>({1, 4, 1, 6}, {2, 1, 0, 3},
+                                  DataType::Float32);
+}
+
 } // namespace infini
@@ -0,0 +1,87 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Relu, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto i = g->addTensor({2, 3}, DataType::Float32);
+    auto op = g->addOp<ReluObj>(i, nullptr);
+    g->dataMalloc();
+    i->setData([](void *ptr, size_t size, DataType) {
+        for (size_t j = 0; j < size; ++j)
+            reinterpret_cast<float *>(ptr)[j] = float(j) - 2.5f;
+    });
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(
+        vector<float>{0, 0, 0, 0.5, 1.5, 2.5}));
+}
+
+TEST(Clip, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto i = g->addTensor({1, 2, 2, 3}, DataType::Float32);
+    auto op = g->addOp<ClipObj>(i, nullptr, 1.0f, 4.0f);
+    auto lower = g->addOp<ClipObj>(i, nullptr, 2.0f, std::nullopt);
+    g->dataMalloc();
+    i->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(
+        vector<float>{1, 1, 2, 3, 4, 4, 4, 4, 4, 4, 4, 4}));
+    EXPECT_TRUE(lower->getOutput()->equalData(
+        vector<float>{2, 2, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+}
+
+TEST(Clip, NativeCpuHalf) {
+    for (auto dtype : {DataType::Float16, DataType::BFloat16}) {
+        SCOPED_TRACE(dtype.toString());
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto i = g->addTensor({3, 100}, dtype);
+        auto relu = g->addOp<ReluObj>(i, nullptr);
+        auto clip = g->addOp<ClipObj>(i, nullptr, 10.5f, 200.f);
+        g->dataMalloc();
+        vector<float> values(i->size());
+        for (size_t j = 0; j < values.size(); ++j)
+            values[j] = float(j % 256) - 40.f;
+        auto bits = roundToHalf(values, dtype);
+        i->setData([&](void *ptr, size_t, DataType) {
+            std::copy(bits.begin(), bits.end(), static_cast<uint16_t *>(ptr));
+        });
+
+        runtime->run(g);
+        vector<float> relued(values.size()), clipped(values.size());
+        for (size_t j = 0; j < values.size(); ++j) {
+            relued[j] = std::max(values[j], 0.f);
+            clipped[j] = std::clamp(values[j], 10.5f, 200.f);
+        }
+        EXPECT_TRUE(relu->getOutput()->equalData(roundToHalf(relued, dtype)));
+        EXPECT_TRUE(
+            clip->getOutput()->equalData(roundToHalf(clipped, dtype)));
+    }
+}
+
+TEST(Clip, NativeCpuInt8) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto i = g->addTensor({6}, DataType::Int8);
+    auto op = g->addOp<ClipObj>(i, nullptr, -3.f, 300.f);
+    g->dataMalloc();
+    i->setData([](void *ptr, size_t, DataType) {
+        int8_t values[] = {-128, -4, -3, 0, 5, 127};
+        std::copy(values, values + 6, static_cast<int8_t *>(ptr));
+    });
+
+    runtime->run(g);
+    // Bounds beyond the range of the type do not clip.
+    EXPECT_TRUE(
+        op->getOutput()->equalData(vector<int8_t>{-3, -3, -3, 0, 5, 127}));
+}
+
+} // namespace infini
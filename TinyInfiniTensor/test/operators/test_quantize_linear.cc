@@ -0,0 +1,35 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/quantize_linear.h"
+
+#include "test.h"
+
+namespace infini {
+
+    TEST(QuantizeLinear, ShapeInference)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i0 = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto q = g->addOp<QuantizeLinearObj>(i0, nullptr,
+                                             QuantParams{{0.5f}, {3}});
+        EXPECT_EQ(q->getOutput()->getDims(), (Shape{2, 3, 4}));
+        EXPECT_EQ(q->getOutDType(), DataType::Int8);
+        EXPECT_TRUE(q->getParams().isPerTensor());
+
+        auto u = g->addOp<QuantizeLinearObj>(i0, nullptr,
+                                             QuantParams{{0.5f}, {128}},
+                                             DataType::UInt8);
+        EXPECT_EQ(u->getOutDType(), DataType::UInt8);
+
+        // A negative channel axis counts from the last dimension.
+        auto dq = g->addOp<DequantizeLinearObj>(
+            u->getOutput(), nullptr,
+            QuantParams{{1.f, 2.f, 3.f, 4.f}, {0, 0, 0, 0}, -1});
+        EXPECT_EQ(dq->getOutput()->getDims(), (Shape{2, 3, 4}));
+        EXPECT_EQ(dq->getOutDType(), DataType::Float32);
+        EXPECT_EQ(dq->getParams().axis, 2);
+    }
+
+} // namespace infini